@@ -15,6 +15,10 @@
 #include <redGrapes/util/trace.hpp>
 #include <redGrapes/redGrapes.hpp>
 
+#ifndef REDGRAPES_INLINE_CONTINUATION_DEPTH
+#define REDGRAPES_INLINE_CONTINUATION_DEPTH 16
+#endif
+
 namespace redGrapes
 {
     /*
@@ -23,30 +27,48 @@ namespace dispatch
 namespace thread
 {*/
 
-void Context::execute_task( Task & task )
+/* run `task`, and if it releases a successor which is kept
+ * in the workers next-slot (see DefaultScheduler::continuation_affinity),
+ * continue with it directly without going through the queues,
+ * up to REDGRAPES_INLINE_CONTINUATION_DEPTH tasks in a row
+ */
+void Context::execute_task( Task & first_task )
 {
-    TRACE_EVENT("Worker", "dispatch task");
-
-    SPDLOG_DEBUG("thread dispatch: execute task {}", task.task_id);
-    assert( task.is_ready() );
+    Task * next = &first_task;
+    for( unsigned depth = 0; next != nullptr; ++depth )
+    {
+        Task & task = *next;
+        next = nullptr;
 
-    task.get_pre_event().notify();
-    current_task = &task;
+        TRACE_EVENT("Worker", "dispatch task");
 
-    auto event = task();
-    
-    if( event )
-    {
-        event->get_event().waker_id = current_worker->get_waker_id();
-        task.sg_pause( *event );
+        SPDLOG_DEBUG("thread dispatch: execute task {}", task.task_id);
+        assert( task.is_ready() );
 
-        task.pre_event.up();
         task.get_pre_event().notify();
-    }
-    else
-        task.get_post_event().notify();
+        current_task = &task;
 
-    current_task = nullptr;
+        if( current_worker )
+            current_worker->stats.tasks_executed.add();
+
+        auto event = task();
+
+        if( event )
+        {
+            event->get_event().waker_id = current_waker_id;
+            task.sg_pause( *event );
+
+            task.pre_event.up();
+            task.get_pre_event().notify();
+        }
+        else
+            task.get_post_event().notify();
+
+        current_task = nullptr;
+
+        if( depth + 1 < REDGRAPES_INLINE_CONTINUATION_DEPTH && current_worker )
+            std::swap( next, current_worker->next_task );
+    }
 }
 
 //} // namespace thread
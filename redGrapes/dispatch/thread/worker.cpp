@@ -6,6 +6,7 @@
  */
 
 #include <atomic>
+#include <chrono>
 #include <hwloc.h>
 #include <redGrapes/scheduler/scheduler.hpp>
 #include <redGrapes/memory/hwloc_alloc.hpp>
@@ -38,6 +39,7 @@ Worker::Worker( memory::ChunkedBumpAlloc<memory::HwlocAlloc> & alloc, HwlocConte
     : alloc( alloc )
     , hwloc_ctx( hwloc_ctx )
     , id( worker_id )
+    , ctx( &SingletonContext::get() )
 {
 }
 
@@ -78,6 +80,7 @@ void WorkerThread::run()
 
     /* initialize thread-local variables
      */
+    Context::current = ctx;
     SingletonContext::get().current_worker = this->shared_from_this();
     SingletonContext::get().current_waker_id = this->get_waker_id();
     SingletonContext::get().current_arena = this->get_worker_id();
@@ -123,14 +126,57 @@ void WorkerThread::membind()
 void Worker::work_loop()
 {
     SPDLOG_TRACE("Worker {} start work_loop()", id);
+    auto & worker_pool = *SingletonContext::get().worker_pool;
+    unsigned const spin_timeout = cv.timeout;
+
+    /* look for work once before sleeping the first time,
+     * since schedulers may only consider this worker while
+     * it looks for tasks (e.g. when forming a gang, see GangScheduler)
+     */
+    wake();
+
     while( ! m_stop.load(std::memory_order_consume) )
     {        
-        SingletonContext::get().worker_pool->set_worker_state( id, dispatch::thread::WorkerState::AVAILABLE );
+        if( retired.load(std::memory_order_acquire) )
+        {
+            /* never show up as available, so no tasks are sent here.
+             * Tasks which still arrive wake us up and are passed on.
+             */
+            worker_pool.set_worker_state( id, dispatch::thread::WorkerState::BUSY );
+            drain();
+
+            cv.timeout = 0;
+            cv.wait();
+            continue;
+        }
+
+        worker_pool.set_worker_state( id, dispatch::thread::WorkerState::AVAILABLE );
+
+        cv.timeout = worker_pool.deep_park.load(std::memory_order_relaxed) ? 0 : spin_timeout;
+
+        auto wait_begin = std::chrono::steady_clock::now();
         cv.wait();
-        
-        while( Task * task = this->gather_task() )
+        auto wait_end = std::chrono::steady_clock::now();
+        stats.wakeups.add();
+        stats.wait_ns.add( std::chrono::duration_cast< std::chrono::nanoseconds >( wait_end - wait_begin ).count() );
+
+        while( ! retired.load(std::memory_order_acquire) )
         {
-            SingletonContext::get().worker_pool->set_worker_state( id, dispatch::thread::WorkerState::BUSY );
+            auto gather_begin = std::chrono::steady_clock::now();
+            Task * task = this->gather_task();
+            stats.gather_ns.add( std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - gather_begin ).count() );
+
+            if( ! task )
+                break;
+
+            // retired meanwhile, let an active worker run it
+            if( retired.load(std::memory_order_acquire) )
+            {
+                SingletonContext::get().scheduler->activate_task( *task );
+                break;
+            }
+
+            worker_pool.set_worker_state( id, dispatch::thread::WorkerState::BUSY );
             SingletonContext::get().execute_task( *task );
         }
 
@@ -143,19 +189,40 @@ Task * Worker::gather_task()
     TRACE_EVENT("Worker", "gather_task()");
     Task * task = nullptr;
 
+    /* STAGE 0:
+     *
+     * continue with a successor of the previous task
+     * if it was kept local
+     */
+    if( next_task )
+    {
+        std::swap( task, next_task );
+        return task;
+    }
+
     /* STAGE 1:
      *
-     * first, execute all tasks in the ready queue
+     * first, execute all tasks in the ready queue,
+     * then those in the queues the scheduler keeps
+     * for this worker (e.g. the priority levels of
+     * the PriorityScheduler)
      */
     SPDLOG_TRACE("Worker {}: consume ready queue", id);
-    if( task = ready_queue.pop() )
+    if( ( task = ready_queue.pop() ) )
+        return task;
+
+    if( ( task = SingletonContext::get().scheduler->pop_ready_task( *this ) ) )
         return task;
 
     /* STAGE 2:
      *
      * after the ready queue is fully consumed,
      * try initializing new tasks until one
-     * of them is found to be ready
+     * of them is found to be ready.
+     * Such a task is run right away and does not pass
+     * through `activate_task()` of the scheduler, so
+     * schedulers which order ready tasks themselves
+     * initialize tasks elsewhere (see InitMode::EAGER).
      */
     SPDLOG_TRACE("Worker {}: try init new tasks", id);
     while( this->init_dependencies( task, true ) )
@@ -184,12 +251,34 @@ Task * Worker::gather_task()
     return task;
 }
 
+void Worker::drain()
+{
+    TRACE_EVENT("Worker", "drain()");
+    auto & scheduler = *SingletonContext::get().scheduler;
+
+    if( Task * task = next_task )
+    {
+        next_task = nullptr;
+        scheduler.activate_task( *task );
+    }
+
+    while( Task * task = ready_queue.pop() )
+        scheduler.activate_task( *task );
+
+    while( Task * task = scheduler.pop_ready_task( *this ) )
+        scheduler.activate_task( *task );
+
+    while( Task * task = emplacement_queue.pop() )
+        scheduler.emplace_task( *task );
+}
+
 bool Worker::init_dependencies( Task* & t, bool claimed )
 {
     TRACE_EVENT("Worker", "init_dependencies()");
     if(Task * task = emplacement_queue.pop())
     {
         SPDLOG_DEBUG("init task {}", task->task_id);
+        stats.tasks_initialized.add();
 
         task->pre_event.up();
         task->init_graph();
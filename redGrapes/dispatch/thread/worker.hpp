@@ -18,6 +18,7 @@
 #include <redGrapes/memory/hwloc_alloc.hpp>
 #include <redGrapes/memory/chunked_bump_alloc.hpp>
 #include <redGrapes/task/queue.hpp>
+#include <redGrapes/dispatch/thread/worker_stats.hpp>
 
 #include <redGrapes/util/trace.hpp>
 #include <redGrapes/dispatch/thread/worker_pool.hpp>
@@ -25,6 +26,8 @@
 namespace redGrapes
 {
 
+struct Context;
+
 namespace dispatch
 {
 namespace thread
@@ -44,13 +47,20 @@ struct Worker
     //private:
     WorkerId id;
 
+    //! context this worker belongs to
+    Context * ctx;
+
     /*! if true, the thread shall stop
      * instead of waiting when it is out of jobs
      */
     std::atomic_bool m_stop{ false };
 
+    /*! if true, the worker is not part of the active workers
+     * of the pool (see WorkerPool::resize()). It hands over
+     * all of its queued tasks and sleeps instead of executing them.
+     */
+    std::atomic_bool retired{ false };
 
-    std::atomic<unsigned> task_count{ 0 };
 
     //! condition variable for waiting if queue is empty
     CondVar cv;
@@ -62,7 +72,17 @@ public:
     HwlocContext & hwloc_ctx;
 
     task::Queue emplacement_queue{ queue_capacity };
-    task::Queue ready_queue{ queue_capacity };
+    task::ReadyQueue ready_queue{ queue_capacity };
+
+    /*! private slot for a task which was released by this worker
+     * and shall run right after the current task
+     * (see DefaultScheduler::continuation_affinity).
+     * Only accessed by the thread executing this worker.
+     */
+    Task * next_task = nullptr;
+
+    //! runtime statistics, only written by the thread executing this worker
+    WorkerCounters stats;
 
     Worker( memory::ChunkedBumpAlloc< memory::HwlocAlloc > & alloc, HwlocContext & hwloc_ctx, hwloc_obj_t const & obj, WorkerId id );
     virtual ~Worker();
@@ -82,6 +102,15 @@ public:
         wake();
     }
 
+    /* adds `n` new tasks to the emplacement queue
+     * with a single wakeup
+     */
+    inline void emplace_tasks( Task ** tasks, size_t n )
+    {
+        emplacement_queue.push_bulk( tasks, n );
+        wake();
+    }
+
     inline void activate_task( Task & task )
     {
         ready_queue.push( &task );
@@ -99,6 +128,12 @@ public:
      */
     Task * gather_task();
 
+    /* pass all queued tasks of this worker
+     * back to the scheduler, which distributes
+     * them among the active workers
+     */
+    void drain();
+
     /*! take a task from the emplacement queue and initialize it,
      * @param t is set to the task if the new task is ready,
      * @param t is set to nullptr if the new task is blocked.
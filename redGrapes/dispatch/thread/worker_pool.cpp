@@ -4,12 +4,14 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include <redGrapes/dispatch/thread/worker.hpp>
 #include <redGrapes/dispatch/thread/worker_pool.hpp>
 #include <redGrapes/memory/allocator.hpp>
 #include <redGrapes/memory/hwloc_alloc.hpp>
 #include <redGrapes/memory/chunked_bump_alloc.hpp>
 #include <redGrapes/redGrapes.hpp>
+#include <redGrapes/scheduler/event.hpp>
 
 //#include <redGrapes_config.hpp>
 
@@ -27,17 +29,24 @@ WorkerPool::WorkerPool( HwlocContext & hwloc_ctx, size_t n_workers )
     Context::current_waker_id = 0;
 }
 
-void WorkerPool::emplace_workers( size_t n_workers )
+void WorkerPool::emplace_workers( size_t n_workers, size_t capacity )
 {
-    unsigned n_pus = hwloc_get_nbobjs_by_type(hwloc_ctx.topology, HWLOC_OBJ_PU);
-    if( n_workers > n_pus )
-        spdlog::warn("{} worker-threads requested, but only {} PUs available!", n_workers, n_pus);
-
-    allocs.reserve( n_workers );
-    workers.reserve( n_workers );
+    capacity = std::max( n_workers, capacity );
 
-    SPDLOG_INFO("populate WorkerPool with {} workers", n_workers);
-    for( size_t worker_id = 0; worker_id < n_workers; ++worker_id )
+    unsigned n_pus = hwloc_get_nbobjs_by_type(hwloc_ctx.topology, HWLOC_OBJ_PU);
+    if( capacity > n_pus )
+        spdlog::warn("{} worker-threads requested, but only {} PUs available!", capacity, n_pus);
+
+    /* reserve all memory upfront, since
+     * `allocs` and `workers` are read concurrently
+     * when the pool is resized later
+     */
+    allocs.reserve( capacity );
+    event_pools.reserve( capacity );
+    workers.reserve( capacity );
+
+    SPDLOG_INFO("populate WorkerPool with {} workers ({} active)", capacity, n_workers);
+    for( size_t worker_id = 0; worker_id < capacity; ++worker_id )
     {
         unsigned pu_id = worker_id % n_pus;
         // allocate worker with id `i` on arena `i`,
@@ -46,12 +55,124 @@ void WorkerPool::emplace_workers( size_t n_workers )
             memory::HwlocAlloc( hwloc_ctx, obj ),
             REDGRAPES_ALLOC_CHUNKSIZE
         );
+        event_pools.emplace_back( std::make_unique< scheduler::ExternalEventPool >( allocs.back() ) );
 
         SingletonContext::get().current_arena = pu_id;
         auto worker = memory::alloc_shared_bind<WorkerThread>( pu_id, get_alloc(pu_id), hwloc_ctx, obj, worker_id );
 //        auto worker = std::make_shared< WorkerThread >( get_alloc(i), hwloc_ctx, obj, i );
+        worker->retired = ( worker_id >= n_workers );
         workers.emplace_back( worker );
     }
+
+    n_active.store( n_workers, std::memory_order_release );
+
+    init_victim_ranges();
+}
+
+size_t WorkerPool::resize( size_t n_workers )
+{
+    std::lock_guard< std::mutex > lock( resize_mutex );
+
+    n_workers = std::min( std::max( n_workers, size_t(1) ), capacity() );
+    size_t old_n_workers = size();
+
+    SPDLOG_INFO("resize WorkerPool from {} to {} workers", old_n_workers, n_workers);
+
+    if( n_workers > old_n_workers )
+    {
+        for( WorkerId worker_id = old_n_workers; worker_id < n_workers; ++worker_id )
+            workers[ worker_id ]->retired = false;
+
+        n_active.store( n_workers, std::memory_order_release );
+
+        for( WorkerId worker_id = old_n_workers; worker_id < n_workers; ++worker_id )
+            workers[ worker_id ]->wake();
+    }
+    else
+    {
+        // stop distributing new tasks to the retiring workers first
+        n_active.store( n_workers, std::memory_order_release );
+
+        for( WorkerId worker_id = n_workers; worker_id < old_n_workers; ++worker_id )
+        {
+            workers[ worker_id ]->retired = true;
+            set_worker_state( worker_id, WorkerState::BUSY );
+            workers[ worker_id ]->wake();
+        }
+    }
+
+    return n_workers;
+}
+
+void WorkerPool::init_victim_ranges()
+{
+    unsigned n_pus = hwloc_get_nbobjs_by_type(hwloc_ctx.topology, HWLOC_OBJ_PU);
+    unsigned n_numa = hwloc_get_nbobjs_by_type(hwloc_ctx.topology, HWLOC_OBJ_NUMANODE);
+
+    /* levels of the topology-tree from which workers
+     * shall be considered as victims, ordered by distance
+     */
+    hwloc_obj_type_t const levels[] = {
+        HWLOC_OBJ_CORE,
+        HWLOC_OBJ_L3CACHE,
+        HWLOC_OBJ_NUMANODE,
+        HWLOC_OBJ_PACKAGE,
+        HWLOC_OBJ_MACHINE
+    };
+
+    auto get_pu = [this, n_pus]( WorkerId worker_id )
+    {
+        return hwloc_get_obj_by_type(hwloc_ctx.topology, HWLOC_OBJ_PU, worker_id % n_pus);
+    };
+
+    victim_ranges.resize( capacity() );
+    for( WorkerId worker_id = 0; worker_id < capacity(); ++worker_id )
+    {
+        hwloc_obj_t pu = get_pu( worker_id );
+        std::vector< bool > visited( capacity(), false );
+        visited[ worker_id ] = true;
+
+        for( hwloc_obj_type_t type : levels )
+        {
+            hwloc_const_cpuset_t cpuset = nullptr;
+
+            if( type == HWLOC_OBJ_NUMANODE )
+            {
+                // NUMA nodes are not part of the main tree in hwloc 2
+                for( unsigned i = 0; i < n_numa; ++i )
+                {
+                    hwloc_obj_t node = hwloc_get_obj_by_type(hwloc_ctx.topology, HWLOC_OBJ_NUMANODE, i);
+                    if( hwloc_bitmap_isincluded( pu->cpuset, node->cpuset ) )
+                        cpuset = node->cpuset;
+                }
+            }
+            else if( type == HWLOC_OBJ_MACHINE )
+                cpuset = nullptr;
+            else if( hwloc_obj_t obj = hwloc_get_ancestor_obj_by_type(hwloc_ctx.topology, type, pu) )
+                cpuset = obj->cpuset;
+            else
+                continue;
+
+            /* collect all workers of this level which are not
+             * covered by a previous level into ranges,
+             * starting with the ones following `worker_id`
+             */
+            std::vector< std::pair< WorkerId, WorkerId > > lower, upper;
+            for( WorkerId i = 0; i < capacity(); ++i )
+                if( ! visited[ i ] && ( !cpuset || hwloc_bitmap_isincluded( get_pu(i)->cpuset, cpuset ) ) )
+                {
+                    visited[ i ] = true;
+                    auto & ranges = ( i < worker_id ) ? lower : upper;
+                    if( !ranges.empty() && ranges.back().second == i )
+                        ranges.back().second = i + 1;
+                    else
+                        ranges.emplace_back( i, i + 1 );
+                }
+
+            victim_ranges[ worker_id ].insert( victim_ranges[ worker_id ].end(), upper.begin(), upper.end() );
+            victim_ranges[ worker_id ].insert( victim_ranges[ worker_id ].end(), lower.begin(), lower.end() );
+        }
+    }
 }
 
 WorkerPool::~WorkerPool()
@@ -6,7 +6,9 @@
  */
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <redGrapes/util/bitfield.hpp>
 #include <redGrapes/memory/hwloc_alloc.hpp>
 #include <redGrapes/memory/chunked_bump_alloc.hpp>
@@ -14,7 +16,12 @@
 namespace redGrapes
 {
 struct HwlocContext;
-  
+
+namespace scheduler
+{
+struct ExternalEventPool;
+}
+
 namespace dispatch
 {
 namespace thread
@@ -33,15 +40,44 @@ struct WorkerPool
     WorkerPool( HwlocContext & hwloc_ctx, size_t n_workers = 1 );
     ~WorkerPool();
 
-    void emplace_workers( size_t n_workers );
+    /* create `max(n_workers, capacity)` workers,
+     * of which only the first `n_workers` are active.
+     * The others are retired until the pool is grown by `resize()`.
+     */
+    void emplace_workers( size_t n_workers, size_t capacity = 0 );
 
-    /* get the number of workers in this pool
+    /* get the number of active workers in this pool,
+     * new tasks are only distributed among those
      */
     inline size_t size()
+    {
+        return n_active.load( std::memory_order_acquire );
+    }
+
+    /* get the number of all workers in this pool,
+     * including the retired ones
+     */
+    inline size_t capacity()
     {
         return workers.size();
     }
 
+    /*! activate or retire workers, so that `n_workers` are active.
+     * Retired workers hand their queued tasks over to the
+     * remaining workers and sleep until they are activated again.
+     * Workers are always retired from the highest id downwards.
+     *
+     * @param n_workers is clamped to [1, capacity()]
+     * @return the new number of active workers
+     */
+    size_t resize( size_t n_workers );
+
+    /*! if set, idle workers go to sleep right away
+     * instead of busy-waiting for new tasks first,
+     * which releases their CPU at the cost of wakeup latency
+     */
+    std::atomic_bool deep_park{ false };
+
     /* signals all workers to start executing tasks
      */
     void start();
@@ -56,14 +92,27 @@ struct WorkerPool
         return allocs[ worker_id ];
     }
 
+    //! recycled memory for external events created on arena `worker_id`
+    inline scheduler::ExternalEventPool & get_event_pool( WorkerId worker_id )
+    {
+        assert( worker_id < event_pools.size() );
+        return *event_pools[ worker_id ];
+    }
+
     inline WorkerThread & get_worker( WorkerId worker_id )
     {
-        assert( worker_id < size() );
+        assert( worker_id < capacity() );
         return *workers[ worker_id ];
     }
 
+    /* workers which are not part of this pool
+     * (e.g. the helping main thread) are always busy
+     */
     inline WorkerState get_worker_state( WorkerId worker_id )
     {
+        if( worker_id >= worker_state.size() )
+            return WorkerState::BUSY;
+
         return worker_state.get(worker_id) ? WorkerState::AVAILABLE : WorkerState::BUSY;
     }
 
@@ -71,9 +120,22 @@ struct WorkerPool
      */
     inline bool set_worker_state( WorkerId worker_id, WorkerState state )
     {
+        if( worker_id >= worker_state.size() )
+            return false;
+
         return worker_state.set( worker_id, state ) != state;
     }
 
+    /* searches for a worker in state `expected_worker_state`
+     * for which `f` returns a value.
+     *
+     * If `start_worker_idx` is a worker of this pool, candidates
+     * are probed in the order of their topological distance to it,
+     * i.e. SMT-siblings first, then workers sharing the same L3 cache,
+     * NUMA node, package and finally all remaining workers.
+     * If `start_worker_idx` is outside of this pool,
+     * all workers are probed.
+     */
     template <typename T, typename F>
     inline std::optional< T >
     probe_worker_by_state(
@@ -82,7 +144,52 @@ struct WorkerPool
         unsigned start_worker_idx,
         bool exclude_start = true)
     {
-        return worker_state.template probe_by_value<T, F>( std::move(f), expected_worker_state, start_worker_idx );
+        if( start_worker_idx < victim_ranges.size() )
+        {
+            if( !exclude_start )
+                if( auto x = worker_state.template probe_range_by_value<T>( f, expected_worker_state, start_worker_idx, start_worker_idx + 1 ) )
+                    return x;
+
+            for( auto const & range : victim_ranges[ start_worker_idx ] )
+                if( auto x = worker_state.template probe_range_by_value<T>( f, expected_worker_state, range.first, range.second ) )
+                    return x;
+
+            return std::nullopt;
+        }
+        else if( start_worker_idx >= worker_state.size() )
+            return worker_state.template probe_by_value<T, F>( std::move(f), expected_worker_state, 0, false );
+        else
+            return worker_state.template probe_by_value<T, F>( std::move(f), expected_worker_state, start_worker_idx );
+    }
+
+    /* like `probe_worker_by_state`, but ignores the topology
+     * and probes workers in the order of their ids,
+     * beginning at `start_worker_idx`
+     */
+    template <typename T, typename F>
+    inline std::optional< T >
+    probe_worker_by_state_linear(
+        F && f,
+        bool expected_worker_state,
+        unsigned start_worker_idx,
+        bool exclude_start = true)
+    {
+        if( start_worker_idx >= worker_state.size() )
+            return worker_state.template probe_by_value<T, F>( std::move(f), expected_worker_state, 0, false );
+        else
+            return worker_state.template probe_by_value<T, F>( std::move(f), expected_worker_state, start_worker_idx, exclude_start );
+    }
+
+    /* true if some worker of the pool is AVAILABLE,
+     * i.e. it is idle or trying to steal a task
+     */
+    inline bool has_available_worker()
+    {
+        return bool( probe_worker_by_state_linear< unsigned >(
+            []( unsigned idx ) -> std::optional< unsigned > { return idx; },
+            true,
+            0,
+            false ) );
     }
 
     /*!
@@ -94,11 +201,33 @@ struct WorkerPool
     int find_free_worker();
     
 private:
+    /* computes `victim_ranges` from the hwloc topology
+     */
+    void init_victim_ranges();
+
     HwlocContext & hwloc_ctx;
 
+    /* for each worker, the other workers ordered by their
+     * topological distance, given as ranges [first, second)
+     * of worker ids. Since workers are bound to PUs in the
+     * logical order of hwloc, each topology-level forms
+     * (mostly) contiguous ranges of bits in `worker_state`,
+     * and probing a level only touches its own chunks.
+     */
+    std::vector< std::vector< std::pair< WorkerId, WorkerId > > > victim_ranges;
+
     std::vector< memory::ChunkedBumpAlloc< memory::HwlocAlloc > > allocs;
+
+    //! destroyed before `allocs`, to which they return their memory
+    std::vector< std::unique_ptr< scheduler::ExternalEventPool > > event_pools;
     std::vector< std::shared_ptr< dispatch::thread::WorkerThread > > workers;
     AtomicBitfield worker_state;
+
+    //! number of active workers, which are those with id < n_active
+    std::atomic< size_t > n_active{ 0 };
+
+    //! serializes calls to `resize()`
+    std::mutex resize_mutex;
 };
 
 } // namespace thread
@@ -0,0 +1,167 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/dispatch/thread/worker_stats.hpp
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fmt/format.h>
+
+namespace redGrapes
+{
+namespace dispatch
+{
+namespace thread
+{
+
+/*! snapshot of the counters of a worker
+ */
+struct WorkerStats
+{
+    uint64_t tasks_executed = 0;
+    uint64_t tasks_initialized = 0;
+
+    uint64_t steal_ready_attempts = 0;
+    uint64_t steal_ready_successes = 0;
+    uint64_t steal_new_attempts = 0;
+    uint64_t steal_new_successes = 0;
+
+    //! number of times the worker returned from waiting
+    uint64_t wakeups = 0;
+
+    //! time spent in `cv.wait()`
+    std::chrono::nanoseconds wait_time{ 0 };
+
+    //! time spent in `gather_task()`
+    std::chrono::nanoseconds gather_time{ 0 };
+
+    WorkerStats & operator+=( WorkerStats const & other )
+    {
+        tasks_executed += other.tasks_executed;
+        tasks_initialized += other.tasks_initialized;
+        steal_ready_attempts += other.steal_ready_attempts;
+        steal_ready_successes += other.steal_ready_successes;
+        steal_new_attempts += other.steal_new_attempts;
+        steal_new_successes += other.steal_new_successes;
+        wakeups += other.wakeups;
+        wait_time += other.wait_time;
+        gather_time += other.gather_time;
+        return *this;
+    }
+};
+
+/*! counter which is only incremented by its owning thread,
+ * so no atomic read-modify-write is needed.
+ * Other threads may read it (or reset it) concurrently,
+ * which only makes the result approximate.
+ */
+struct StatCounter
+{
+    std::atomic< uint64_t > value{ 0 };
+
+    inline void add( uint64_t n = 1 )
+    {
+        value.store( value.load( std::memory_order_relaxed ) + n, std::memory_order_relaxed );
+    }
+
+    inline uint64_t get() const
+    {
+        return value.load( std::memory_order_relaxed );
+    }
+
+    inline void reset()
+    {
+        value.store( 0, std::memory_order_relaxed );
+    }
+};
+
+/*! counters of a worker, always enabled.
+ * They live in their own cache-line(s) and are
+ * only written by the thread running the worker.
+ */
+struct alignas(64) WorkerCounters
+{
+    StatCounter tasks_executed;
+    StatCounter tasks_initialized;
+
+    StatCounter steal_ready_attempts;
+    StatCounter steal_ready_successes;
+    StatCounter steal_new_attempts;
+    StatCounter steal_new_successes;
+
+    StatCounter wakeups;
+    StatCounter wait_ns;
+    StatCounter gather_ns;
+
+    WorkerStats snapshot() const
+    {
+        WorkerStats s;
+        s.tasks_executed = tasks_executed.get();
+        s.tasks_initialized = tasks_initialized.get();
+        s.steal_ready_attempts = steal_ready_attempts.get();
+        s.steal_ready_successes = steal_ready_successes.get();
+        s.steal_new_attempts = steal_new_attempts.get();
+        s.steal_new_successes = steal_new_successes.get();
+        s.wakeups = wakeups.get();
+        s.wait_time = std::chrono::nanoseconds( wait_ns.get() );
+        s.gather_time = std::chrono::nanoseconds( gather_ns.get() );
+        return s;
+    }
+
+    void reset()
+    {
+        tasks_executed.reset();
+        tasks_initialized.reset();
+        steal_ready_attempts.reset();
+        steal_ready_successes.reset();
+        steal_new_attempts.reset();
+        steal_new_successes.reset();
+        wakeups.reset();
+        wait_ns.reset();
+        gather_ns.reset();
+    }
+};
+
+} // namespace thread
+} // namespace dispatch
+} // namespace redGrapes
+
+template <>
+struct fmt::formatter< redGrapes::dispatch::thread::WorkerStats >
+{
+    constexpr auto parse( format_parse_context& ctx )
+    {
+        return ctx.begin();
+    }
+
+    template < typename FormatContext >
+    auto format(
+        redGrapes::dispatch::thread::WorkerStats const & s,
+        FormatContext & ctx
+    )
+    {
+        return fmt::format_to(
+                   ctx.out(),
+                   "{{ \"tasks_executed\" : {}, \"tasks_initialized\" : {}, "
+                   "\"steal_ready\" : [{}, {}], \"steal_new\" : [{}, {}], "
+                   "\"wakeups\" : {}, \"wait_ns\" : {}, \"gather_ns\" : {} }}",
+                   s.tasks_executed,
+                   s.tasks_initialized,
+                   s.steal_ready_successes, s.steal_ready_attempts,
+                   s.steal_new_successes, s.steal_new_attempts,
+                   s.wakeups,
+                   s.wait_time.count(),
+                   s.gather_time.count());
+    }
+};
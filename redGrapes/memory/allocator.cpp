@@ -14,19 +14,20 @@ Allocator::Allocator()
   : Allocator(SingletonContext::get().current_arena) {}
 
 Allocator::Allocator( dispatch::thread::WorkerId worker_id )
-  : worker_id(
-        worker_id % SingletonContext::get().n_workers
+  : ctx( &SingletonContext::get() )
+  , worker_id(
+        worker_id % ctx->n_workers
     )
 {}
 
 Block Allocator::allocate( size_t n_bytes )
 {
-    return SingletonContext::get().worker_pool->get_alloc( worker_id ).allocate( n_bytes );
+    return ctx->worker_pool->get_alloc( worker_id ).allocate( n_bytes );
 }
 
 void Allocator::deallocate( Block blk )
 {
-    SingletonContext::get().worker_pool->get_alloc( worker_id ).deallocate( blk );
+    ctx->worker_pool->get_alloc( worker_id ).deallocate( blk );
 }
 
 } // namespace memory
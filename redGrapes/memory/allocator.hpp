@@ -20,11 +20,15 @@ namespace thread
 
 extern std::shared_ptr< dispatch::thread::WorkerPool > worker_pool;
 
+struct Context;
+
 namespace memory
 {
 
 struct Allocator
 {   
+    //! context owning the worker pool, the current one at construction
+    Context * ctx;
     dispatch::thread::WorkerId worker_id;
 
     // allocate on `current_arena` given by `SingletonContext`
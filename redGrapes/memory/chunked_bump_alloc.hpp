@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <boost/core/demangle.hpp>
 #include <cstddef>
@@ -80,7 +81,11 @@ struct ChunkedBumpAlloc
     Block allocate( std::size_t n = 1 ) noexcept
     {
         TRACE_EVENT("Allocator", "ChunkedBumpAlloc::allocate()");
-        size_t alloc_size = roundup_to_poweroftwo( n );
+        /* chunks are filled downwards from their (aligned) upper limit,
+         * so sizes of at least max_align_t keep every block aligned.
+         * EventPtr relies on this to store its tag in the low bits.
+         */
+        size_t alloc_size = roundup_to_poweroftwo( std::max( n, alignof( std::max_align_t ) ) );
  
         size_t const chunk_capacity = bump_allocators.get_chunk_capacity();
 
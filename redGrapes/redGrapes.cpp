@@ -5,6 +5,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <algorithm>
 #include <optional>
 #include <functional>
 #include <memory>
@@ -25,17 +26,18 @@ PERFETTO_TRACK_EVENT_STATIC_STORAGE();
 namespace redGrapes
 {
 
+thread_local Context * Context::current;
 thread_local Task *  Context::current_task;
 thread_local std::function< void() > Context::idle;
 thread_local unsigned Context::next_worker;
 thread_local unsigned Context::current_arena;
 thread_local scheduler::WakerId Context::current_waker_id;
-thread_local std::shared_ptr< dispatch::thread::WorkerThread > Context::current_worker;
+thread_local std::shared_ptr< dispatch::thread::Worker > Context::current_worker;
 
 Context::Context()
 {
-    idle = [this] {
-        this->scheduler->idle();
+    idle = [] {
+        SingletonContext::get().scheduler->idle();
     };
 }
 
@@ -100,6 +102,21 @@ std::vector<std::reference_wrapper<Task>> Context::backtrace()
     return bt;
 }
     
+std::vector< dispatch::thread::WorkerStats > Context::stats() const
+{
+    std::vector< dispatch::thread::WorkerStats > s;
+    for( dispatch::thread::WorkerId i = 0; i < worker_pool->capacity(); ++i )
+        s.push_back( worker_pool->get_worker( i ).stats.snapshot() );
+
+    return s;
+}
+
+void Context::reset_stats()
+{
+    for( dispatch::thread::WorkerId i = 0; i < worker_pool->capacity(); ++i )
+        worker_pool->get_worker( i ).stats.reset();
+}
+
 void Context::init_tracing()
 {
 #if REDGRAPES_ENABLE_TRACE
@@ -119,16 +136,29 @@ void Context::finalize_tracing()
 #endif
 }
 
-void Context::init( size_t n_workers, std::shared_ptr<scheduler::IScheduler> scheduler )
+void Context::restrict_cpuset( hwloc_const_cpuset_t cpuset )
 {
+    assert( ! worker_pool );
+    if( hwloc_topology_restrict( hwloc_ctx.topology, cpuset, 0 ) )
+        throw std::runtime_error("could not restrict topology to cpuset");
+}
+
+void Context::init( size_t n_workers, std::shared_ptr<scheduler::IScheduler> scheduler, size_t max_workers )
+{
+    // workers and scheduler pick up the context they are created in
+    ContextScope scope( *this );
+
     init_tracing();
 
+    max_workers = std::max( n_workers, max_workers );
+
     this->n_workers = n_workers;
-    worker_pool = std::make_shared<dispatch::thread::WorkerPool>( hwloc_ctx, n_workers );
-    worker_pool->emplace_workers( n_workers );
+    worker_pool = std::make_shared<dispatch::thread::WorkerPool>( hwloc_ctx, max_workers );
+    worker_pool->emplace_workers( n_workers, max_workers );
 
-    root_space = std::make_shared<TaskSpace>();
+    root_space = std::make_shared<TaskSpace>( *this );
     this->scheduler = scheduler;
+    this->scheduler->init();
 
     worker_pool->start();
 }
@@ -138,11 +168,18 @@ void Context::init( size_t n_workers )
     init( n_workers, std::make_shared<scheduler::DefaultScheduler>());
 }
 
+size_t Context::resize_workers( size_t n_workers )
+{
+    this->n_workers = worker_pool->resize( n_workers );
+    return this->n_workers;
+}
+
 /*! wait until all tasks in the current task space finished
  */
 void Context::barrier()
 {
     SPDLOG_TRACE("barrier");
+    ContextScope scope( *this );
 
     while( ! root_space->empty() )
         idle();
@@ -150,8 +187,10 @@ void Context::barrier()
 
 void Context::finalize()
 {
+    ContextScope scope( *this );
     barrier();
 
+    scheduler->finalize();
     worker_pool->stop();
 
     scheduler.reset();
@@ -10,6 +10,10 @@
 #pragma once
 
 #include <memory> // std::shared_ptr
+#include <tuple>
+#include <vector>
+#include <iterator>
+#include <utility>
 #include <spdlog/spdlog.h>
 
 #include <redGrapes/scheduler/event.hpp>
@@ -18,12 +22,29 @@
 //#include <redGrapes/task/future.hpp>
 #include <redGrapes/task/task.hpp>
 #include <redGrapes/task/task_space.hpp>
+#include <redGrapes/task/task_graph.hpp>
 #include <redGrapes/memory/hwloc_alloc.hpp>
 #include <redGrapes/dispatch/thread/worker.hpp>
 
 namespace redGrapes
 {
 
+/*! Selects the worker (and thereby the memory arena)
+ * on which a newly emplaced task is allocated and initialized
+ */
+enum class PlacementPolicy
+{
+    //! distribute tasks evenly over all workers
+    ROUND_ROBIN,
+
+    /*! use the arena of the tasks dominant resource,
+     * i.e. the first synchronizing (e.g. write) access,
+     * or the first access if there is none.
+     * Tasks without resources are placed round-robin.
+     */
+    RESOURCE_AFFINITY
+};
+
 struct Context
 {
     Context();
@@ -32,10 +53,30 @@ struct Context
     void init_tracing();
     void finalize_tracing();
 
-    void init( size_t n_workers, std::shared_ptr<scheduler::IScheduler> scheduler);
+    /*!
+     * @param n_workers number of workers which are active initially
+     * @param max_workers number of workers the pool can grow to
+     *                    with `resize_workers()`, at least `n_workers`
+     */
+    void init( size_t n_workers, std::shared_ptr<scheduler::IScheduler> scheduler, size_t max_workers = 0 );
     void init( size_t n_workers = std::thread::hardware_concurrency() );
     void finalize();
 
+    /*! confine the workers and memory arenas of this context
+     * to the PUs in `cpuset`, e.g. the cpuset of a package.
+     * Must be called before `init()`.
+     */
+    void restrict_cpuset( hwloc_const_cpuset_t cpuset );
+
+    /*! change the number of active workers at runtime,
+     * within the capacity given to `init()`.
+     * Retired workers pass their queued tasks to the others
+     * and sleep without consuming CPU time until reactivated.
+     *
+     * @return the new number of active workers
+     */
+    size_t resize_workers( size_t n_workers );
+
     //! wait until all tasks in the current task space finished
     void barrier();
 
@@ -59,6 +100,12 @@ struct Context
     unsigned scope_depth() const;
     std::shared_ptr<TaskSpace> current_task_space() const;
 
+    //! snapshot of the runtime statistics of each worker
+    std::vector< dispatch::thread::WorkerStats > stats() const;
+
+    //! set the runtime statistics of all workers to zero
+    void reset_stats();
+
     void execute_task( Task & task );
 
     /*! create a new task, as child of the currently running task (if there is one)
@@ -76,21 +123,47 @@ struct Context
     template< typename Callable, typename... Args >
     auto emplace_task(Callable&& f, Args&&... args);
 
+    /*! create one task for each element of a range,
+     * as children of the currently running task (if there is one).
+     * All tasks are submitted at once, which saves the
+     * per-task overhead of queueing and waking up workers.
+     *
+     * @param range elements to create tasks for
+     * @param f callable which is copied into each task
+     * @param access_fn maps an element of `range` to a std::tuple
+     *                  of arguments for f, which are handled
+     *                  like the args of `emplace_task()`
+     *
+     * The results of the tasks are discarded.
+     */
+    template< typename Range, typename Callable, typename AccessFn >
+    void emplace_tasks(Range&& range, Callable&& f, AccessFn&& access_fn);
+
+    /*! context of the calling thread, which is used by `SingletonContext::get()`.
+     * It is set in the threads of each context and by `ContextScope`.
+     */
+    static thread_local Context * current;
+
     static thread_local Task * current_task;
     static thread_local std::function< void () > idle;
     static thread_local unsigned next_worker;
 
     static thread_local scheduler::WakerId current_waker_id;
-    static thread_local std::shared_ptr< dispatch::thread::WorkerThread > current_worker;
+    static thread_local std::shared_ptr< dispatch::thread::Worker > current_worker;
 
     unsigned n_workers;
     static thread_local unsigned current_arena;
+    PlacementPolicy placement_policy = PlacementPolicy::ROUND_ROBIN;
     HwlocContext hwloc_ctx;
     std::shared_ptr< dispatch::thread::WorkerPool > worker_pool;
 
     std::shared_ptr< TaskSpace > root_space;
     std::shared_ptr< scheduler::IScheduler > scheduler;
 
+    //! graph which records the tasks submitted to `recording_space` (see TaskGraph)
+    TaskGraph * recording = nullptr;
+    TaskSpace * recording_space = nullptr;
+
 #if REDGRAPES_ENABLE_TRACE
     std::shared_ptr< perfetto::TracingSession > tracing_session;
 #endif
@@ -102,17 +175,77 @@ struct Context
  * ~ ~ ~ ~ ~ ~ ~ ~ ~ ~ 
  */
 
+/* returns the context of the calling thread,
+ * i.e. the one its worker belongs to or the one
+ * selected by `ContextScope`. All other threads
+ * use the global default context.
+ */
 struct SingletonContext
 {
     inline static Context & get()
     {
+        if( Context::current )
+            return *Context::current;
+
         static Context ctx;
         return ctx;
     }
 };
 
-inline void init( size_t n_workers, std::shared_ptr<scheduler::IScheduler> scheduler ) {
-    SingletonContext::get().init( n_workers, scheduler); }
+/*! makes `ctx` the context of the calling thread
+ * for the lifetime of this object, so the free functions
+ * (`rg::emplace_task()`, `rg::barrier()`, ...) act on `ctx`.
+ *
+ * When switching to another context, the thread-local state
+ * of the previous one (current task, worker and arena) is put aside,
+ * so e.g. a task emplaced into `ctx` from within a task of another
+ * context becomes a root task of `ctx` and not a child of the running task.
+ */
+struct ContextScope
+{
+    Context * prev;
+    bool switched;
+
+    Task * prev_task;
+    std::shared_ptr< dispatch::thread::Worker > prev_worker;
+    scheduler::WakerId prev_waker_id;
+    unsigned prev_arena;
+
+    ContextScope( Context & ctx )
+        : prev( Context::current )
+        , switched( &ctx != &SingletonContext::get() )
+    {
+        if( switched )
+        {
+            prev_task = Context::current_task;
+            prev_worker = std::move( Context::current_worker );
+            prev_waker_id = Context::current_waker_id;
+            prev_arena = Context::current_arena;
+
+            Context::current_task = nullptr;
+            Context::current_worker.reset();
+            Context::current_waker_id = 0;
+        }
+
+        Context::current = &ctx;
+    }
+
+    ~ContextScope()
+    {
+        Context::current = prev;
+
+        if( switched )
+        {
+            Context::current_task = prev_task;
+            Context::current_worker = std::move( prev_worker );
+            Context::current_waker_id = prev_waker_id;
+            Context::current_arena = prev_arena;
+        }
+    }
+};
+
+inline void init( size_t n_workers, std::shared_ptr<scheduler::IScheduler> scheduler, size_t max_workers = 0 ) {
+    SingletonContext::get().init( n_workers, scheduler, max_workers ); }
 
 inline void init( size_t n_workers = std::thread::hardware_concurrency() ) {
     SingletonContext::get().init( n_workers ); }
@@ -120,6 +253,12 @@ inline void init( size_t n_workers = std::thread::hardware_concurrency() ) {
 inline void finalize() {
     SingletonContext::get().finalize(); }
 
+inline size_t resize_workers( size_t n_workers ) {
+    return SingletonContext::get().resize_workers( n_workers ); }
+
+inline void set_deep_park( bool deep_park ) {
+    SingletonContext::get().worker_pool->deep_park = deep_park; }
+
 inline void barrier() {
     SingletonContext::get().barrier(); }
 
@@ -135,6 +274,15 @@ inline std::vector<std::reference_wrapper<Task>> backtrace() {
 inline std::optional<scheduler::EventPtr> create_event() {
     return SingletonContext::get().create_event(); }
 
+inline void set_placement_policy( PlacementPolicy policy ) {
+    SingletonContext::get().placement_policy = policy; }
+
+inline std::vector< dispatch::thread::WorkerStats > stats() {
+    return SingletonContext::get().stats(); }
+
+inline void reset_stats() {
+    SingletonContext::get().reset_stats(); }
+
 inline unsigned scope_depth() {
     return SingletonContext::get().scope_depth(); }
 
@@ -150,6 +298,14 @@ inline auto emplace_task(Callable&& f, Args&&... args) {
                )
            ); }
 
+template<typename Range, typename Callable, typename AccessFn>
+inline void emplace_tasks(Range&& range, Callable&& f, AccessFn&& access_fn) {
+    SingletonContext::get().emplace_tasks(
+        std::forward<Range>(range),
+        std::forward<Callable>(f),
+        std::forward<AccessFn>(access_fn)
+    ); }
+
 } //namespace redGrapes
 
 
@@ -159,9 +315,42 @@ inline auto emplace_task(Callable&& f, Args&&... args) {
 
 namespace redGrapes
 {
+    /* find the arena of the dominant resource among the task arguments
+     */
+    struct ResourceAffinity
+    {
+        int arena_id = -1;
+        bool synchronizing = false;
+
+        template < typename T >
+        inline typename std::enable_if< std::is_convertible< T, ResourceAccess >::value, int >::type
+        visit( T const & arg )
+        {
+            if( ! synchronizing )
+            {
+                ResourceAccess const & access = arg;
+                if( arena_id < 0 || access.is_synchronizing() )
+                {
+                    arena_id = access.arena_id();
+                    synchronizing = access.is_synchronizing();
+                }
+            }
+            return 0;
+        }
+
+        template < typename T >
+        inline typename std::enable_if< ! std::is_convertible< T, ResourceAccess >::value, int >::type
+        visit( T const & )
+        {
+            return 0;
+        }
+    };
+
     template<typename Callable, typename... Args>
     auto Context::emplace_task(Callable&& f, Args&&... args)
     {
+        ContextScope scope( *this );
+
         dispatch::thread::WorkerId worker_id =
          // linear
     	    next_worker % worker_pool->size();
@@ -169,12 +358,88 @@ namespace redGrapes
          // interleaved
     //    2*next_worker % worker_pool->size() + ((2*next_worker) / worker_pool->size())%2;
 
-        next_worker++;
+        if( placement_policy == PlacementPolicy::RESOURCE_AFFINITY )
+        {
+            // braced init-list, so the arguments are visited from left to right
+            ResourceAffinity affinity;
+            int dummy[] = { 0, ( affinity.visit( args ), 0 )... };
+            (void) dummy;
+
+            if( affinity.arena_id >= 0 )
+                worker_id = affinity.arena_id;
+            else
+                next_worker++;
+        }
+        else
+            next_worker++;
+
         current_arena = worker_id;
 
         SPDLOG_TRACE("emplace task to worker {} next_worker={}", worker_id, next_worker);
 
         return std::move(TaskBuilder< Callable, Args... >( std::move(f), std::forward<Args>(args)... ));
     }
-} // namespace redGrapes
 
+    template < typename... Args, size_t... Is >
+    inline int get_resource_affinity( std::tuple< Args... > const & args, std::index_sequence< Is... > )
+    {
+        // braced init-list, so the arguments are visited from left to right
+        ResourceAffinity affinity;
+        int dummy[] = { 0, ( affinity.visit( std::get< Is >( args ) ), 0 )... };
+        (void) dummy;
+        return affinity.arena_id;
+    }
+
+    /* construct a task from a tuple of arguments,
+     * but do not submit it yet
+     */
+    template < typename Callable, typename... Args, size_t... Is >
+    inline Task * build_task( Callable && f, std::tuple< Args... > && args, std::index_sequence< Is... > )
+    {
+        return TaskBuilder< Callable, Args... >( std::move(f), std::move(std::get< Is >( args ))... ).detach();
+    }
+
+    template< typename Range, typename Callable, typename AccessFn >
+    void Context::emplace_tasks(Range&& range, Callable&& f, AccessFn&& access_fn)
+    {
+        size_t n = std::distance( std::begin(range), std::end(range) );
+        if( n == 0 )
+            return;
+
+        ContextScope scope( *this );
+
+        std::vector< Task * > tasks;
+        tasks.reserve( n );
+
+        /* distribute the range in contiguous blocks over the workers,
+         * so the tasks of each worker are allocated adjacently in its arena
+         */
+        unsigned first_worker = next_worker++;
+
+        size_t i = 0;
+        for( auto && x : range )
+        {
+            auto args = access_fn( x );
+            using Indices = std::make_index_sequence< std::tuple_size< decltype(args) >::value >;
+
+            dispatch::thread::WorkerId worker_id = (first_worker + i * worker_pool->size() / n) % worker_pool->size();
+            if( placement_policy == PlacementPolicy::RESOURCE_AFFINITY )
+            {
+                int arena_id = get_resource_affinity( args, Indices{} );
+                if( arena_id >= 0 )
+                    worker_id = arena_id;
+            }
+            current_arena = worker_id;
+
+            tasks.push_back( build_task( std::decay_t< Callable >( f ), std::move( args ), Indices{} ) );
+            ++i;
+        }
+
+        SPDLOG_TRACE("emplace {} tasks", n);
+        current_task_space()->submit_bulk( tasks.data(), n );
+
+        // results are not needed
+        for( Task * task : tasks )
+            task->get_result_get_event().notify();
+    }
+} // namespace redGrapes
@@ -20,13 +20,14 @@ unsigned int ResourceBase::generateID()
 }
 
 ResourceBase::ResourceBase()
-    : id( generateID() )
+    : ctx( SingletonContext::get() )
+    , id( generateID() )
     , scope_level( scope_depth() )
     , users( memory::Allocator( get_arena_id() ) )
 {}
 
 unsigned ResourceBase::get_arena_id() const {
-    return id % SingletonContext::get().worker_pool->size();
+    return id % ctx.worker_pool->size();
 }
 
 } // namespace redGrapes
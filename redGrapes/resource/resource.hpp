@@ -39,6 +39,7 @@ template <typename AccessPolicy>
 class Resource;
 
 struct Task;
+struct Context;
 
 class ResourceBase
 {
@@ -46,6 +47,9 @@ protected:
     static unsigned int generateID();
 
 public:
+    //! context the resource was created in, its tasks must belong to it
+    Context & ctx;
+
     unsigned int id;
     unsigned int scope_level;
 
@@ -151,6 +155,11 @@ class ResourceAccess
         return this->obj->resource->id;
     }
 
+    unsigned arena_id() const
+    {
+        return this->obj->resource->get_arena_id();
+    }
+
     std::string mode_format() const
     {
         return this->obj->mode_format();
@@ -0,0 +1,179 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <redGrapes/scheduler/blocking_scheduler.hpp>
+#include <redGrapes/dispatch/thread/worker.hpp>
+#include <redGrapes/util/trace.hpp>
+#include <redGrapes/redGrapes.hpp>
+#include <spdlog/spdlog.h>
+
+namespace redGrapes
+{
+namespace scheduler
+{
+
+BlockingScheduler::BlockingScheduler( size_t n_threads )
+    : n_threads( n_threads )
+{
+}
+
+BlockingScheduler::~BlockingScheduler()
+{
+    finalize();
+}
+
+void BlockingScheduler::init()
+{
+    if( ! threads.empty() )
+        return;
+
+    auto & ctx = SingletonContext::get();
+    stop = false;
+
+    /* worker ids following the worker pool and the
+     * helping main thread (see DefaultScheduler::main_thread_helps),
+     * so their waker ids do not collide with any other thread
+     */
+    dispatch::thread::WorkerId first_id = ctx.worker_pool->capacity() + 1;
+
+    idle.reset( new std::atomic_bool[ n_threads ] );
+    for( size_t i = 0; i < n_threads; ++i )
+        idle[ i ] = false;
+
+    for( size_t i = 0; i < n_threads; ++i )
+        workers.push_back( std::make_shared< dispatch::thread::Worker >(
+                               ctx.worker_pool->get_alloc( i % ctx.worker_pool->size() ),
+                               ctx.hwloc_ctx,
+                               hwloc_get_root_obj( ctx.hwloc_ctx.topology ),
+                               first_id + i ) );
+
+    SPDLOG_INFO("start {} threads for blocking tasks", n_threads);
+    for( size_t i = 0; i < n_threads; ++i )
+        threads.emplace_back( [this, &ctx, i] {
+            // deliberately no cpubind, these threads shall float
+            Context::current = &ctx;
+            ctx.current_worker = workers[ i ];
+            ctx.current_waker_id = workers[ i ]->get_waker_id();
+            ctx.current_arena = i % ctx.worker_pool->size();
+
+            work_loop( i );
+
+            ctx.current_worker.reset();
+        });
+}
+
+void BlockingScheduler::finalize()
+{
+    if( threads.empty() )
+        return;
+
+    stop = true;
+    wake_all();
+
+    for( auto & thread : threads )
+        thread.join();
+
+    threads.clear();
+    workers.clear();
+}
+
+void BlockingScheduler::work_loop( size_t i )
+{
+    dispatch::thread::Worker & worker = *workers[ i ];
+
+    while( ! stop.load( std::memory_order_acquire ) )
+    {
+        while( true )
+        {
+            Task * task = ready_queue.pop();
+
+            if( ! task )
+                if( ( task = emplacement_queue.pop() ) )
+                {
+                    TRACE_EVENT("BlockingScheduler", "init_dependencies");
+                    worker.stats.tasks_initialized.add();
+
+                    task->pre_event.up();
+                    task->init_graph();
+
+                    // if it is not ready yet, it is activated later
+                    if( ! task->get_pre_event().notify( true ) )
+                        continue;
+                }
+
+            if( ! task )
+                break;
+
+            SingletonContext::get().execute_task( *task );
+        }
+
+        idle[ i ].store( true );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+
+        /* a task which was queued before we were marked as idle
+         * did not wake us, so check again. If somebody claimed
+         * this thread meanwhile, its notification is kept by `cv`.
+         */
+        if( ready_queue.size_approx() > 0 || emplacement_queue.size_approx() > 0 )
+            if( idle[ i ].exchange( false ) )
+                continue;
+
+        worker.cv.timeout = 0;
+        worker.cv.wait();
+        worker.stats.wakeups.add();
+
+        idle[ i ].store( false );
+    }
+}
+
+/* claims an idle thread and wakes it up. If none is idle,
+ * all threads are busy and the next one to finish picks up the task.
+ */
+void BlockingScheduler::wake_one()
+{
+    // pairs with the fence after marking a thread as idle in `work_loop()`
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+
+    for( size_t i = 0; i < workers.size(); ++i )
+        if( idle[ i ].load() && idle[ i ].exchange( false ) )
+        {
+            workers[ i ]->wake();
+            return;
+        }
+}
+
+void BlockingScheduler::emplace_task( Task & task )
+{
+    emplacement_queue.push( &task );
+    wake_one();
+}
+
+void BlockingScheduler::activate_task( Task & task )
+{
+    ready_queue.push( &task );
+    wake_one();
+}
+
+bool BlockingScheduler::wake( WakerId id )
+{
+    for( auto & worker : workers )
+        if( worker->get_waker_id() == id )
+            return worker->wake();
+
+    return false;
+}
+
+void BlockingScheduler::wake_all()
+{
+    for( auto & worker : workers )
+        worker->wake();
+}
+
+} // namespace scheduler
+} // namespace redGrapes
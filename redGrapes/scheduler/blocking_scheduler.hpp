@@ -0,0 +1,98 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/scheduler/blocking_scheduler.hpp
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <redGrapes/dispatch/thread/worker.hpp>
+#include <redGrapes/scheduler/scheduler.hpp>
+#include <redGrapes/task/queue.hpp>
+
+#ifndef REDGRAPES_BLOCKING_THREADS
+#define REDGRAPES_BLOCKING_THREADS 8
+#endif
+
+namespace redGrapes
+{
+namespace scheduler
+{
+
+/*! Scheduler for tasks which block in syscalls (I/O, sleep, ...).
+ *
+ * Its tasks run on a separate group of threads which are
+ * not bound to any PU and may oversubscribe the machine,
+ * so a blocked task does not occupy a compute worker.
+ * Successors of finished tasks are activated through their own
+ * scheduler as usual, which wakes up the compute workers.
+ *
+ * Use it as sub-scheduler of `TagMatch`, e.g.
+ *
+ *     rg::init( n, rg::scheduler::make_tag_match_scheduler()
+ *                    .add( {}, std::make_shared< DefaultScheduler >() )
+ *                    .add( { SCHED_BLOCKING }, std::make_shared< BlockingScheduler >() ) );
+ */
+struct BlockingScheduler : IScheduler
+{
+    //! number of threads in the group
+    size_t n_threads;
+
+    //! new tasks, which still need their dependencies to be initialized
+    task::Queue emplacement_queue;
+
+    //! tasks which are ready to run
+    task::Queue ready_queue;
+
+    /*! worker-objects of the blocking threads, they are not part of
+     * the worker pool and only take tasks from the queues above
+     */
+    std::vector< std::shared_ptr< dispatch::thread::Worker > > workers;
+    std::vector< std::thread > threads;
+    std::atomic_bool stop{ false };
+
+    /*! set by each thread before it goes to sleep, and cleared
+     * by whoever claims it for a new task (see `wake_one()`).
+     * A thread which is awake, e.g. blocked inside a task, is never
+     * marked idle, so new tasks do not queue up behind it.
+     */
+    std::unique_ptr< std::atomic_bool [] > idle;
+
+    BlockingScheduler( size_t n_threads = REDGRAPES_BLOCKING_THREADS );
+    ~BlockingScheduler();
+
+    //! start the threads
+    void init();
+
+    //! stop and join the threads
+    void finalize();
+
+    void emplace_task( Task & task );
+    void activate_task( Task & task );
+
+    bool wake( WakerId id );
+    void wake_all();
+
+private:
+    //! wake up one idle thread, so it checks the queues
+    void wake_one();
+
+    /* executes tasks from the queues until `stop` is set
+     */
+    void work_loop( size_t i );
+};
+
+} // namespace scheduler
+} // namespace redGrapes
@@ -0,0 +1,257 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/scheduler/critical_path_scheduler.hpp
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <redGrapes/sync/spinlock.hpp>
+#include <redGrapes/task/property/cost.hpp>
+#include <redGrapes/scheduler/default_scheduler.hpp>
+#include <redGrapes/redGrapes.hpp>
+
+#ifndef REDGRAPES_BOTTOM_LEVEL_PROPAGATION_DEPTH
+#define REDGRAPES_BOTTOM_LEVEL_PROPAGATION_DEPTH 16
+#endif
+
+namespace redGrapes
+{
+namespace scheduler
+{
+
+/*!
+ * Variant of the DefaultScheduler which orders ready tasks
+ * by their bottom-level, i.e. the estimated cost of the longest
+ * path from the task to the end of the task-graph (CP-first).
+ *
+ * Since the task-graph is only known incrementally, the bottom-level
+ * of each task is updated whenever a new edge is created
+ * (see `task_dependency_type()`) and propagated upwards through
+ * predecessors which are not yet ready, up to a depth of
+ * REDGRAPES_BOTTOM_LEVEL_PROPAGATION_DEPTH edges.
+ *
+ * Requires `CostProperty` to be part of the task properties.
+ *
+ * Like the PriorityScheduler, new tasks are initialized eagerly,
+ * so that every ready task is ordered in the heaps.
+ */
+struct CriticalPathScheduler : DefaultScheduler
+{
+    using Entry = std::pair< float, Task * >;
+
+    struct EntryCompare
+    {
+        bool operator() ( Entry const & a, Entry const & b ) const
+        {
+            return a.first < b.first;
+        }
+    };
+
+    struct ReadyHeap
+    {
+        SpinLock mutex;
+        std::priority_queue< Entry, std::vector< Entry >, EntryCompare > heap;
+
+        void push( Task * task )
+        {
+            std::lock_guard< SpinLock > lock( mutex );
+            heap.emplace( task->bottom_level.load( std::memory_order_relaxed ), task );
+        }
+
+        Task * pop()
+        {
+            std::lock_guard< SpinLock > lock( mutex );
+            if( heap.empty() )
+                return nullptr;
+
+            Task * task = heap.top().second;
+            heap.pop();
+            return task;
+        }
+    };
+
+    //! ready tasks of each worker, ordered by bottom-level
+    std::vector< std::unique_ptr< ReadyHeap > > ready_heaps;
+
+    CriticalPathScheduler()
+    {
+        init_mode = InitMode::EAGER;
+    }
+
+    void init()
+    {
+        DefaultScheduler::init();
+
+        ready_heaps.clear();
+        for( size_t i = 0; i < SingletonContext::get().worker_pool->capacity(); ++i )
+            ready_heaps.emplace_back( new ReadyHeap() );
+    }
+
+    /* raise the bottom-level of `task` to at least `bottom_level`
+     * and propagate the change to its (pinned) predecessors.
+     *
+     * Predecessors are visited with an explicit worklist, only one
+     * predecessors-mutex is held at a time and each task is only expanded
+     * further if its bottom-level actually increased.
+     * A predecessor is kept alive by the pin of its successor, which
+     * may be released as soon as the successor gets ready, so each
+     * task on the worklist holds an additional pin.
+     */
+    static void propagate_bottom_level( Task & task, float bottom_level, unsigned depth )
+    {
+        struct Item
+        {
+            Task * task;
+            float bottom_level;
+            unsigned depth;
+        };
+
+        auto raise = []( Task & t, float level )
+        {
+            float old_level = t.bottom_level.load( std::memory_order_relaxed );
+            do {
+                if( level <= old_level )
+                    return false;
+            } while( ! t.bottom_level.compare_exchange_weak( old_level, level ) );
+            return true;
+        };
+
+        if( ! raise( task, bottom_level ) || depth == 0 )
+            return;
+
+        std::vector< Item > worklist;
+        auto expand = [&worklist]( Task & t, float level, unsigned d )
+        {
+            std::lock_guard< SpinLock > lock( t.predecessors_mutex );
+            for( GraphProperty * p : t.predecessors )
+            {
+                p->pin();
+                worklist.push_back( Item{ &**p, (**p).cost + level, d - 1 } );
+            }
+        };
+
+        expand( task, bottom_level, depth );
+        while( ! worklist.empty() )
+        {
+            Item item = worklist.back();
+            worklist.pop_back();
+
+            if( raise( *item.task, item.bottom_level ) && item.depth > 0 )
+                expand( *item.task, item.bottom_level, item.depth );
+
+            item.task->unpin();
+        }
+    }
+
+    /* called while the edge a -> b is created in `init_graph()`,
+     * with the users-mutex of a shared resource locked,
+     * so task `a` can not be freed concurrently
+     */
+    bool task_dependency_type( Task const & a, Task const & b )
+    {
+        Task & pred = const_cast< Task & >( a );
+        Task & succ = const_cast< Task & >( b );
+
+        if( ! pred.post_event.is_reached() )
+        {
+            pred.pin();
+            std::lock_guard< SpinLock > lock( succ.predecessors_mutex );
+            succ.predecessors.push_back( &pred );
+        }
+
+        propagate_bottom_level(
+            pred,
+            pred.cost + succ.bottom_level.load( std::memory_order_relaxed ),
+            REDGRAPES_BOTTOM_LEVEL_PROPAGATION_DEPTH );
+
+        return false;
+    }
+
+    void activate_task( Task & task )
+    {
+        //! worker id to use in case all workers are busy
+        static thread_local unsigned next_worker = 0;
+
+        TRACE_EVENT("Scheduler", "CriticalPathScheduler::activate_task");
+        SPDLOG_TRACE("CriticalPathScheduler::activate_task({}), bottom level = {}", task.task_id, task.bottom_level);
+
+        /* the task is ready, so there is no further need
+         * to propagate its bottom-level to its predecessors
+         */
+        decltype(task.predecessors) predecessors;
+        {
+            std::lock_guard< SpinLock > lock( task.predecessors_mutex );
+            std::swap( predecessors, task.predecessors );
+        }
+        for( GraphProperty * p : predecessors )
+            p->unpin();
+
+        auto & worker_pool = *SingletonContext::get().worker_pool;
+
+        int worker_id = worker_pool.find_free_worker();
+        if( worker_id < 0 )
+            worker_id = next_worker++ % worker_pool.size();
+
+        ready_heaps[ worker_id ]->push( &task );
+
+        worker_pool.set_worker_state( worker_id, dispatch::thread::WorkerState::BUSY );
+        worker_pool.get_worker( worker_id ).wake();
+    }
+
+    //! one by one, each task goes into the heap of some worker
+    void activate_tasks( Task ** tasks, size_t n )
+    {
+        IScheduler::activate_tasks( tasks, n );
+    }
+
+    /* take the task with the highest bottom-level from the own queue
+     */
+    Task * pop_ready_task( dispatch::thread::Worker & worker )
+    {
+        if( worker.get_worker_id() < ready_heaps.size() )
+            return ready_heaps[ worker.get_worker_id() ]->pop();
+        else
+            return nullptr;
+    }
+
+    Task * steal_task( dispatch::thread::Worker & worker )
+    {
+        auto & worker_pool = *SingletonContext::get().worker_pool;
+
+        std::optional< Task * > task = worker_pool.template probe_worker_by_state< Task * >(
+            [this]( unsigned idx ) -> std::optional< Task * >
+            {
+                if( Task * t = ready_heaps[ idx ]->pop() )
+                    return t;
+                else
+                    return std::nullopt;
+            },
+            dispatch::thread::WorkerState::BUSY,
+            worker.get_worker_id() );
+
+        if( task )
+        {
+            worker_pool.set_worker_state( worker.get_worker_id(), dispatch::thread::WorkerState::BUSY );
+            return *task;
+        }
+
+        return DefaultScheduler::steal_task( worker );
+    }
+};
+
+} // namespace scheduler
+} // namespace redGrapes
@@ -1,4 +1,7 @@
 
+#include <algorithm>
+#include <random>
+#include <thread>
 #include <redGrapes/dispatch/thread/worker.hpp>
 #include <redGrapes/scheduler/default_scheduler.hpp>
 #include <redGrapes/util/trace.hpp>
@@ -14,10 +17,79 @@ DefaultScheduler::DefaultScheduler( )
 {
 }
 
+DefaultScheduler::~DefaultScheduler()
+{
+    finalize();
+}
+
+void DefaultScheduler::init()
+{
+    if( init_mode == InitMode::BUILDER_THREAD && ! builder_thread.joinable() )
+    {
+        builder_stop = false;
+        builder_thread = std::thread([this, ctx = &SingletonContext::get()] {
+            Context::current = ctx;
+            while( ! builder_stop.load( std::memory_order_acquire ) )
+            {
+                builder_cv.wait();
+                while( Task * task = builder_queue.pop() )
+                    init_task( *task );
+            }
+        });
+    }
+
+    if( main_thread_helps )
+    {
+        auto & ctx = SingletonContext::get();
+        helper = std::make_shared< dispatch::thread::Worker >(
+                     ctx.worker_pool->get_alloc( 0 ),
+                     ctx.hwloc_ctx,
+                     hwloc_get_root_obj( ctx.hwloc_ctx.topology ),
+                     ctx.worker_pool->capacity() );
+    }
+}
+
+void DefaultScheduler::finalize()
+{
+    if( builder_thread.joinable() )
+    {
+        builder_stop = true;
+        builder_cv.notify();
+        builder_thread.join();
+    }
+}
+
 void DefaultScheduler::idle()
 {
     SPDLOG_TRACE("DefaultScheduler::idle()");
 
+    /* help the workers by executing one task,
+     * the caller will check its wait-condition again after that
+     */
+    if( helper && ! SingletonContext::get().current_worker
+        && ! helper_in_use.test_and_set( std::memory_order_acquire ) )
+    {
+        auto & ctx = SingletonContext::get();
+
+        ctx.current_worker = helper;
+        Task * task = helper->gather_task();
+        if( task )
+            ctx.execute_task( *task );
+        ctx.current_worker.reset();
+
+        if( ! task )
+        {
+            // nothing to steal, sleep until wake(0) or a task gets ready
+            helper_waiting = true;
+            cv.timeout = 0;
+            cv.wait();
+            helper_waiting = false;
+        }
+
+        helper_in_use.clear( std::memory_order_release );
+        return;
+    }
+
     /* the main thread shall not do any busy waiting
      * and always sleep right away in order to
      * not block any worker threads (those however should
@@ -31,6 +103,21 @@ void DefaultScheduler::idle()
  */
 void DefaultScheduler::emplace_task( Task & task )
 {
+    switch( init_mode )
+    {
+    case InitMode::EAGER:
+        init_task( task );
+        return;
+
+    case InitMode::BUILDER_THREAD:
+        builder_queue.push( &task );
+        builder_cv.notify();
+        return;
+
+    default:
+        break;
+    }
+
     // todo: properly store affinity information in task
     dispatch::thread::WorkerId worker_id = task.arena_id % SingletonContext::get().worker_pool->size();
 
@@ -62,6 +149,69 @@ void DefaultScheduler::emplace_task( Task & task )
 #endif
 }
 
+/* create the dependency edges of a new task
+ * and activate it if it is ready
+ */
+void DefaultScheduler::init_task( Task & task )
+{
+    TRACE_EVENT("Scheduler", "init_task");
+    SPDLOG_DEBUG("init task {}", task.task_id);
+
+    task.pre_event.up();
+    task.init_graph();
+    task.get_pre_event().notify();
+}
+
+/* send a batch of new tasks to their workers,
+ * waking up each worker only once
+ */
+void DefaultScheduler::emplace_tasks( Task ** tasks, size_t n )
+{
+    TRACE_EVENT("Scheduler", "emplace_tasks");
+
+    if( init_mode == InitMode::BUILDER_THREAD )
+    {
+        builder_queue.push_bulk( tasks, n );
+        builder_cv.notify();
+        return;
+    }
+    else if( init_mode != InitMode::ON_WORKER )
+    {
+        IScheduler::emplace_tasks( tasks, n );
+        return;
+    }
+
+    auto & worker_pool = *SingletonContext::get().worker_pool;
+    size_t n_workers = worker_pool.size();
+
+    /* tasks of the same worker are usually adjacent,
+     * so push each run of them with one bulk-enqueue
+     */
+    size_t begin = 0;
+    while( begin < n )
+    {
+        dispatch::thread::WorkerId worker_id = tasks[begin]->arena_id % n_workers;
+
+        size_t end = begin + 1;
+        while( end < n && tasks[end]->arena_id % n_workers == worker_id )
+            ++end;
+
+        worker_pool.get_worker( worker_id ).emplacement_queue.push_bulk( tasks + begin, end - begin );
+        begin = end;
+    }
+
+    std::vector< bool > woken( n_workers, false );
+    for( size_t i = 0; i < n; ++i )
+    {
+        dispatch::thread::WorkerId worker_id = tasks[i]->arena_id % n_workers;
+        if( ! woken[ worker_id ] )
+        {
+            woken[ worker_id ] = true;
+            worker_pool.get_worker( worker_id ).wake();
+        }
+    }
+}
+
 /* send this already existing task to a worker,
  * but only through follower-list so it is not assigned to a worker yet.
  * since this task is now ready, send find a worker for it
@@ -74,17 +224,157 @@ void DefaultScheduler::activate_task( Task & task )
     TRACE_EVENT("Scheduler", "activate_task");
     SPDLOG_TRACE("DefaultScheduler::activate_task({})", task.task_id);
 
+    /* if the successor was released by the post-event of the
+     * task which just finished on this worker, keep it local.
+     * Threads outside of the pool (the helping main thread or
+     * the threads of a BlockingScheduler) never keep successors.
+     */
+    if( continuation_affinity )
+        if( auto & current_worker = SingletonContext::get().current_worker )
+            if( current_worker->get_worker_id() < SingletonContext::get().worker_pool->capacity()
+                && current_worker->next_task == nullptr
+                && SingletonContext::get().current_task
+                && SingletonContext::get().current_task->post_event.is_reached() )
+            {
+                current_worker->next_task = &task;
+                return;
+            }
+
     int worker_id = SingletonContext::get().worker_pool->find_free_worker();
     if( worker_id < 0 )
     {
         worker_id = next_worker.fetch_add(1) % SingletonContext::get().worker_pool->size();
-        if( worker_id == SingletonContext::get().current_worker->get_worker_id() )
+        if( SingletonContext::get().current_worker
+            && worker_id == SingletonContext::get().current_worker->get_worker_id() )
             worker_id = next_worker.fetch_add(1) % SingletonContext::get().worker_pool->size();
+
+        // all workers are busy, let the waiting main thread steal it
+        if( helper_waiting )
+            cv.notify();
     }
 
-    SingletonContext::get().worker_pool->get_worker( worker_id ).ready_queue.push(&task);
+    /* only the owning worker may push to the bottom end
+     * of its own ready queue, all others go through the inbox
+     */
+    auto & worker = SingletonContext::get().worker_pool->get_worker( worker_id );
+    if( SingletonContext::get().current_worker.get() == &worker )
+        worker.ready_queue.push_local(&task);
+    else
+        worker.ready_queue.push(&task);
+
     SingletonContext::get().worker_pool->set_worker_state( worker_id, dispatch::thread::WorkerState::BUSY );
-    SingletonContext::get().worker_pool->get_worker( worker_id ).wake();
+    worker.wake();
+}
+
+void DefaultScheduler::activate_tasks( Task ** tasks, size_t n )
+{
+    TRACE_EVENT("Scheduler", "activate_tasks");
+    if( n == 0 )
+        return;
+
+    // may be kept as continuation of the current task
+    DefaultScheduler::activate_task( *tasks[0] );
+
+    auto & ctx = SingletonContext::get();
+    auto & worker_pool = *ctx.worker_pool;
+
+    auto push = [&ctx]( dispatch::thread::Worker & worker, Task * task )
+    {
+        if( ctx.current_worker.get() == &worker )
+            worker.ready_queue.push_local( task );
+        else
+            worker.ready_queue.push( task );
+    };
+
+    size_t i = 1;
+    for( ; i < n; ++i )
+    {
+        int worker_id = worker_pool.find_free_worker();
+        if( worker_id < 0 )
+            break;
+
+        auto & worker = worker_pool.get_worker( worker_id );
+        push( worker, tasks[i] );
+        worker.wake();
+    }
+
+    if( i == n )
+        return;
+
+    /* all workers are busy, keep the rest at the current worker
+     * (or some worker if called from outside of the pool)
+     * where the others can steal them from
+     */
+    static thread_local unsigned next_worker = 0;
+    dispatch::thread::WorkerId worker_id =
+        ( ctx.current_worker && ctx.current_worker->get_worker_id() < worker_pool.size() )
+        ? ctx.current_worker->get_worker_id()
+        : next_worker++ % worker_pool.size();
+
+    auto & worker = worker_pool.get_worker( worker_id );
+    for( ; i < n; ++i )
+        push( worker, tasks[i] );
+
+    worker_pool.set_worker_state( worker_id, dispatch::thread::WorkerState::BUSY );
+    worker.wake();
+
+    if( helper_waiting )
+        cv.notify();
+}
+
+/* pick a uniformly distributed random worker id
+ */
+static unsigned random_worker_id()
+{
+    static thread_local std::minstd_rand rng( std::hash< std::thread::id >{}( std::this_thread::get_id() ) );
+    return rng() % SingletonContext::get().worker_pool->size();
+}
+
+/* searches a busy worker (other than `worker`) for which `f`
+ * returns a task, in the order given by `steal_policy`.
+ * `queue_size(idx)` estimates the number of stealable tasks
+ * of worker `idx`, used for StealPolicy::POWER_OF_TWO
+ */
+template < typename F, typename S >
+std::optional< Task * > DefaultScheduler::probe_victims( dispatch::thread::Worker & worker, F && f, S && queue_size )
+{
+    auto & worker_pool = *SingletonContext::get().worker_pool;
+    unsigned self = worker.get_worker_id();
+
+    auto others = [self, &f]( unsigned idx ) -> std::optional< Task * >
+    {
+        if( idx == self )
+            return std::nullopt;
+        else
+            return f( idx );
+    };
+
+    switch( steal_policy )
+    {
+    case StealPolicy::LINEAR:
+        return worker_pool.probe_worker_by_state_linear< Task * >( std::move( others ), dispatch::thread::WorkerState::BUSY, self );
+
+    case StealPolicy::POWER_OF_TWO:
+    {
+        // sample two victims and try the one with the longer queue first
+        unsigned a = random_worker_id();
+        unsigned b = random_worker_id();
+        unsigned victim = ( queue_size( a ) >= queue_size( b ) ) ? a : b;
+
+        if( worker_pool.get_worker_state( victim ) == dispatch::thread::WorkerState::BUSY )
+            if( std::optional< Task * > task = others( victim ) )
+                return task;
+        // otherwise fall back to a random probe
+    }
+    // fall through
+
+    case StealPolicy::RANDOM:
+        return worker_pool.probe_worker_by_state_linear< Task * >( std::move( others ), dispatch::thread::WorkerState::BUSY, random_worker_id(), false );
+
+    case StealPolicy::TOPOLOGY:
+    default:
+        return worker_pool.probe_worker_by_state< Task * >( std::move( others ), dispatch::thread::WorkerState::BUSY, self );
+    }
 }
 
 /* tries to find a task with uninialized dependency edges in the
@@ -93,7 +383,10 @@ void DefaultScheduler::activate_task( Task & task )
  */
 Task * DefaultScheduler::steal_new_task( dispatch::thread::Worker & worker )
 {
-    std::optional<Task*> task = SingletonContext::get().worker_pool->probe_worker_by_state<Task*>(
+    worker.stats.steal_new_attempts.add();
+
+    std::optional<Task*> task = probe_victims(
+        worker,
         [&worker](unsigned idx) -> std::optional<Task*>
         {
             // we have a candidate of a busy worker,
@@ -102,34 +395,61 @@ Task * DefaultScheduler::steal_new_task( dispatch::thread::Worker & worker )
                 return t;
 
             // otherwise check own queue again
-                else if(Task* t = worker.emplacement_queue.pop())
-                    return t;
+            else if(Task* t = worker.emplacement_queue.pop())
+                return t;
 
-                // else continue search
-                else
-                    return std::nullopt;
-            },
+            // else continue search
+            else
+                return std::nullopt;
+        },
+        [](unsigned idx)
+        {
+            return SingletonContext::get().worker_pool->get_worker(idx).emplacement_queue.size_approx();
+        });
 
-            // find a busy worker
-            dispatch::thread::WorkerState::BUSY,
+    return task ? *task : nullptr;
+}
 
-            // start next to current worker
-            worker.get_worker_id());
+/* take one task from the ready queue of `victim`, or if `steal_half` is set,
+ * up to half of its tasks and move the surplus into the own ready queue
+ */
+Task * DefaultScheduler::steal_from( dispatch::thread::Worker & worker, dispatch::thread::Worker & victim )
+{
+    if( steal_half && worker.get_worker_id() < SingletonContext::get().worker_pool->capacity() )
+    {
+        size_t n = std::min( ( victim.ready_queue.size_approx() + 1 ) / 2, size_t( REDGRAPES_STEAL_BULK_MAX ) );
+        if( n > 1 )
+        {
+            Task * tasks[ REDGRAPES_STEAL_BULK_MAX ];
+            size_t k = victim.ready_queue.steal_bulk( tasks, n );
 
-        return task ? *task : nullptr;
+            for( size_t i = 1; i < k; ++i )
+                if( SingletonContext::get().current_worker.get() == &worker )
+                    worker.ready_queue.push_local( tasks[i] );
+                else
+                    worker.ready_queue.push( tasks[i] );
+
+            return ( k > 0 ) ? tasks[0] : nullptr;
+        }
     }
 
+    return victim.ready_queue.steal();
+}
+
     /* tries to find a ready task in any queue of other workers
      * and removes it from the queue
      */
     Task * DefaultScheduler::steal_ready_task( dispatch::thread::Worker & worker )
     {
-        std::optional<Task*> task = SingletonContext::get().worker_pool->probe_worker_by_state<Task*>(
-            [&worker](unsigned idx) -> std::optional<Task*>
+        worker.stats.steal_ready_attempts.add();
+
+        std::optional<Task*> task = probe_victims(
+            worker,
+            [this, &worker](unsigned idx) -> std::optional<Task*>
             {
                 // we have a candidate of a busy worker,
                 // now check its queue
-                if(Task* t = SingletonContext::get().worker_pool->get_worker(idx).ready_queue.pop())
+                if(Task* t = steal_from(worker, SingletonContext::get().worker_pool->get_worker(idx)))
                     return t;
 
                 // otherwise check own queue again
@@ -140,12 +460,10 @@ Task * DefaultScheduler::steal_new_task( dispatch::thread::Worker & worker )
                 else
                     return std::nullopt;
             },
-
-            // find a busy worker
-            dispatch::thread::WorkerState::BUSY,
-
-            // start next to current worker
-            worker.get_worker_id());
+            [](unsigned idx)
+            {
+                return SingletonContext::get().worker_pool->get_worker(idx).ready_queue.size_approx();
+            });
 
         return task ? *task : nullptr;
     }
@@ -160,12 +478,16 @@ Task * DefaultScheduler::steal_new_task( dispatch::thread::Worker & worker )
 
         if( Task * task = steal_ready_task( worker ) )
         {
+            worker.stats.steal_ready_successes.add();
             SingletonContext::get().worker_pool->set_worker_state( worker_id, dispatch::thread::WorkerState::BUSY );
             return task;
         }
 
         if( Task * task = steal_new_task( worker ) )
         {
+            worker.stats.steal_new_successes.add();
+            worker.stats.tasks_initialized.add();
+
             task->pre_event.up();
             task->init_graph();
 
@@ -190,7 +512,7 @@ Task * DefaultScheduler::steal_new_task( dispatch::thread::Worker & worker )
     {
         if( id == 0 )
             return cv.notify();
-        else if( id > 0 && id <= SingletonContext::get().worker_pool->size() )
+        else if( id > 0 && id <= SingletonContext::get().worker_pool->capacity() )
             return SingletonContext::get().worker_pool->get_worker(id - 1).wake();
         else
             return false;
@@ -200,7 +522,7 @@ Task * DefaultScheduler::steal_new_task( dispatch::thread::Worker & worker )
      */
     void DefaultScheduler::wake_all()
     {
-        for( uint16_t i = 0; i <= SingletonContext::get().worker_pool->size(); ++i )
+        for( uint16_t i = 0; i <= SingletonContext::get().worker_pool->capacity(); ++i )
             this->wake( i );
     }
 
@@ -12,6 +12,10 @@
 
 #include <redGrapes/scheduler/scheduler.hpp>
 
+#ifndef REDGRAPES_STEAL_BULK_MAX
+#define REDGRAPES_STEAL_BULK_MAX 32
+#endif
+
 namespace redGrapes
 {
 namespace scheduler
@@ -25,20 +29,118 @@ struct DefaultScheduler : public IScheduler
 {
     CondVar cv;
 
+    /*! where the dependencies of new tasks are initialized
+     */
+    enum class InitMode
+    {
+        //! lazily by the worker the task is emplaced to (or a thief)
+        ON_WORKER,
+
+        /*! directly by the thread submitting the task,
+         * only ready tasks are sent to workers
+         */
+        EAGER,
+
+        /*! by a dedicated graph-builder thread,
+         * only ready tasks are sent to workers
+         */
+        BUILDER_THREAD
+    };
+
+    InitMode init_mode = InitMode::ON_WORKER;
+
+    /*! order in which busy workers are probed when stealing
+     */
+    enum class StealPolicy
+    {
+        //! in the order of worker ids, starting next to the thief
+        LINEAR,
+
+        //! in the order of worker ids, starting at a random worker
+        RANDOM,
+
+        /*! first the worker with the longer queue
+         * out of two random samples, then like RANDOM
+         */
+        POWER_OF_TWO,
+
+        /*! in the order of topological distance
+         * (see WorkerPool::probe_worker_by_state)
+         */
+        TOPOLOGY
+    };
+
+    StealPolicy steal_policy = StealPolicy::TOPOLOGY;
+
+    /*! if set, a thief takes up to half of the ready tasks of its
+     * victim at once (at most REDGRAPES_STEAL_BULK_MAX)
+     */
+    bool steal_half = false;
+
+    /*! if set, a worker which releases a successor by finishing
+     * its current task keeps this successor in its private
+     * next-slot and runs it right after, instead of sending
+     * it to another (idle, but cold) worker.
+     * Only the surplus of released tasks is distributed.
+     */
+    bool continuation_affinity = false;
+
+    /*! if set, the main thread does not just sleep in `idle()`
+     * (i.e. in barrier() or when waiting for a future),
+     * but acts as additional worker and steals tasks
+     * from the other workers.
+     */
+    bool main_thread_helps = false;
+
+    /*! worker-object used by the main thread when helping,
+     * it is not part of the worker pool and only steals
+     */
+    std::shared_ptr< dispatch::thread::Worker > helper;
+    std::atomic_flag helper_in_use = ATOMIC_FLAG_INIT;
+    std::atomic_bool helper_waiting{ false };
+
+    //! new tasks waiting for the builder thread (InitMode::BUILDER_THREAD)
+    task::Queue builder_queue;
+    CondVar builder_cv;
+    std::atomic_bool builder_stop{ false };
+    std::thread builder_thread;
+
     DefaultScheduler();
+    ~DefaultScheduler();
+
+    void init();
+    void finalize();
 
-   void idle();
+    void idle();
 
-    /* send the new task to a worker
+    /* send the new task to a worker,
+     * or initialize it right away depending on `init_mode`
      */
     void emplace_task( Task & task );
 
+    /* create the dependency edges of a new task
+     * and activate it if it is ready
+     */
+    void init_task( Task & task );
+
+    /* send a batch of new tasks to their workers,
+     * waking up each worker only once
+     */
+    void emplace_tasks( Task ** tasks, size_t n );
+
     /* send this already existing,
      * but only through follower-list so it is not assigned to a worker yet.
      * since this task is now ready, send find a worker for it
      */
     void activate_task( Task & task );
 
+    /* activate the tasks released by one notification:
+     * the first one is activated like in activate_task(),
+     * then each free worker gets one, and the remaining ones
+     * are queued at a single worker with one wakeup
+     */
+    void activate_tasks( Task ** tasks, size_t n );
+
     /* tries to find a task with uninialized dependency edges in the
      * task-graph in the emplacement queues of other workers
      * and removes it from there
@@ -50,6 +152,15 @@ struct DefaultScheduler : public IScheduler
      */
     Task * steal_ready_task( dispatch::thread::Worker & worker );
 
+    /* take a ready task from `victim`, see `steal_half`
+     */
+    Task * steal_from( dispatch::thread::Worker & worker, dispatch::thread::Worker & victim );
+
+    /* probe busy workers according to `steal_policy`
+     */
+    template < typename F, typename S >
+    std::optional< Task * > probe_victims( dispatch::thread::Worker & worker, F && f, S && queue_size );
+
     // give worker a ready task if available
     // @return task if a new task was found, nullptr otherwise
     Task * steal_task( dispatch::thread::Worker & worker );
@@ -10,6 +10,7 @@
 #include <shared_mutex>
 #include <cassert>
 #include <memory>
+#include <vector>
 #include <spdlog/spdlog.h>
 
 #include <redGrapes/redGrapes.hpp>
@@ -75,16 +76,64 @@ void Event::notify_followers()
 {
     TRACE_EVENT("Event", "notify_followers");
 
-    for( auto follower = followers.rbegin(); follower != followers.rend(); ++follower )
-        follower->notify();
+    followers.for_each( []( EventPtr & follower ) { follower.notify(); } );
 }
 
+/* events reached and tasks made ready during one
+ * notification on this thread
+ */
+struct NotifyWave
+{
+    //! set while the outermost notify() is running
+    bool active = false;
+
+    //! followers of reached events which are not notified yet
+    std::vector< EventPtr > pending;
+
+    //! tasks whose pre-event got ready
+    std::vector< Task * > ready;
+    std::vector< Task * > activating;
+
+    //! tasks to free once the ready tasks are activated
+    std::vector< Task * > released;
+};
+
+static thread_local NotifyWave notify_wave;
+
+/* marks the notification wave of this thread as active,
+ * and resets it at the end, also if a scheduler throws,
+ * so the next notify() does not append to a dead wave
+ */
+struct NotifyWaveScope
+{
+    NotifyWave & wave;
+
+    NotifyWaveScope( NotifyWave & wave )
+        : wave( wave )
+    {
+        wave.active = true;
+    }
+
+    ~NotifyWaveScope()
+    {
+        wave.pending.clear();
+        wave.ready.clear();
+        wave.activating.clear();
+        wave.released.clear();
+        wave.active = false;
+    }
+};
+
 /*! A preceding event was reached and thus an incoming edge got removed.
- * This events state is decremented and recursively notifies its followers
+ * This events state is decremented and its followers are notified
  * in case it is now also reached.
  *
+ * Instead of recursing into the followers, they are queued in
+ * the notification wave of this thread, which the outermost call
+ * processes iteratively, so long chains of events do not grow the stack.
+ *
  * @param claimed if true, the scheduler already knows about the task,
- *                if false, activate task is called
+ *                if false, the task is activated at the end of the wave
  *
  * @return true if event is ready
  */
@@ -92,11 +141,26 @@ bool EventPtr::notify( bool claimed )
 {
     TRACE_EVENT("Event", "notify");
 
+    if( notify_wave.active )
+        return notify_one( claimed );
+
+    NotifyWaveScope scope( notify_wave );
+    bool ready = notify_one( claimed );
+    propagate();
+
+    return ready;
+}
+
+bool EventPtr::notify_one( bool claimed )
+{
     int old_state = this->get_event().state.fetch_sub(1);
     int state = old_state - 1;
 
+    EventPtrTag tag = this->get_tag();
+    Task * task = this->get_task();
+
     std::string tag_string;
-    switch( this->tag )
+    switch( tag )
     {
     case EventPtrTag::T_EVT_PRE: tag_string = "pre"; break;
     case EventPtrTag::T_EVT_POST: tag_string = "post"; break;
@@ -105,13 +169,17 @@ bool EventPtr::notify( bool claimed )
     case EventPtrTag::T_EVT_EXT: tag_string = "external"; break;
     }
 
-    if( this->task )
+    if( task )
         SPDLOG_TRACE("notify event {} ({}-event of task {}) ~~> state = {}",
-               (void *)&this->get_event(), tag_string, this->task->task_id, state);
+               (void *)&this->get_event(), tag_string, task->task_id, state);
 
     assert(old_state > 0);
 
-    bool remove_task = false;
+    /* read before the event can go away,
+     * the waker is woken up after the event was processed
+     */
+    Context & ctx = task ? task->space->ctx : SingletonContext::get();
+    WakerId waker_id = this->get_event().waker_id;
 
     if(task)
     {
@@ -119,7 +187,11 @@ bool EventPtr::notify( bool claimed )
         if(tag == scheduler::T_EVT_PRE && state == 1)
         {
             if(!claimed)
-                SingletonContext::get().scheduler->activate_task(*task);
+                notify_wave.ready.push_back( task );
+
+            if( waker_id >= 0 )
+                ctx.scheduler->wake( waker_id );
+            return true;
         }
 
         // post event reached:
@@ -129,13 +201,9 @@ bool EventPtr::notify( bool claimed )
             task->delete_from_resources();
     }
 
-    // if event is ready or reached (state ∈ {0,1})
-    if( state <= 1 && this->get_event().waker_id >= 0 )
-        SingletonContext::get().scheduler->wake( this->get_event().waker_id );
-
     if( state == 0 )
     {
-        this->get_event().notify_followers();
+        this->get_event().followers.for_each( []( EventPtr & follower ) { notify_wave.pending.push_back( follower ); } );
 
         // the second one of either post-event or result-get-event shall destroy the task
         if( task )
@@ -143,14 +211,65 @@ bool EventPtr::notify( bool claimed )
              || tag == scheduler::T_EVT_RES_GET )
             {
                 if( task->removal_countdown.fetch_sub(1) == 1 )
-                    task->space->free_task( task );
+                    notify_wave.released.push_back( task );
             }
     }
 
+    // if event is ready or reached (state ∈ {0,1})
+    if( state <= 1 && waker_id >= 0 )
+        ctx.scheduler->wake( waker_id );
+
     // return true if event is ready (state == 1)
     return state == 1;
 }
 
+void EventPtr::propagate()
+{
+    TRACE_EVENT("Event", "propagate");
+    NotifyWave & wave = notify_wave;
+
+    while( true )
+    {
+        while( ! wave.pending.empty() )
+        {
+            EventPtr follower = std::move( wave.pending.back() );
+            wave.pending.pop_back();
+            follower.notify_one( false );
+        }
+
+        if( wave.ready.empty() )
+            break;
+
+        /* hand the ready tasks to the scheduler of their context,
+         * one batch for each run of tasks with the same context.
+         * Activated tasks may run and be freed immediately,
+         * so the context of the next run is read before.
+         */
+        std::swap( wave.ready, wave.activating );
+        Task ** tasks = wave.activating.data();
+        size_t n = wave.activating.size();
+        for( size_t begin = 0; begin < n; )
+        {
+            Context & ctx = tasks[begin]->space->ctx;
+
+            size_t end = begin + 1;
+            while( end < n && &tasks[end]->space->ctx == &ctx )
+                ++end;
+
+            ctx.scheduler->activate_tasks( tasks + begin, end - begin );
+            begin = end;
+        }
+        wave.activating.clear();
+    }
+
+    /* tasks are only freed after the activation,
+     * schedulers may still look at the current task
+     */
+    for( Task * task : wave.released )
+        task->space->free_task( task );
+    wave.released.clear();
+}
+
 } // namespace scheduler
 
 } // namespace redGrapes
@@ -7,19 +7,28 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <mutex>
 #include <shared_mutex>
 #include <cassert>
 #include <memory>
 #include <spdlog/spdlog.h>
+#include <redGrapes/memory/allocator.hpp>
+#include <redGrapes/memory/chunked_bump_alloc.hpp>
+#include <redGrapes/memory/hwloc_alloc.hpp>
 #include <redGrapes/scheduler/scheduler.hpp>
+#include <redGrapes/sync/spinlock.hpp>
 #include <redGrapes/util/chunked_list.hpp>
 
 #ifndef REDGRAPES_EVENT_FOLLOWER_LIST_CHUNKSIZE
 #define REDGRAPES_EVENT_FOLLOWER_LIST_CHUNKSIZE 16
 #endif
 
+#ifndef REDGRAPES_EVENT_FOLLOWER_INLINE_SLOTS
+#define REDGRAPES_EVENT_FOLLOWER_INLINE_SLOTS 4
+#endif
+
 namespace std
 {
     using shared_mutex = shared_timed_mutex;
@@ -34,6 +43,7 @@ namespace scheduler
 {
 
 struct Event;
+struct ExternalEvent;
 
 enum EventPtrTag {
     T_UNINITIALIZED = 0,
@@ -44,15 +54,65 @@ enum EventPtrTag {
     T_EVT_EXT,
 };
 
+/*! Tagged pointer to an event, which is either one of the events
+ * of a task or an external event.
+ * The tag is stored in the low bits of the pointer,
+ * so each follower-entry takes only 8 bytes.
+ *
+ * External events are refcounted intrusively by the EventPtrs
+ * pointing to them. Pointers to task events do not touch
+ * any refcount, the lifetime of tasks is managed by their events.
+ */
 struct EventPtr
 {
-    enum EventPtrTag tag;
-    Task * task;
-    std::shared_ptr< Event > external_event;
+    static constexpr uintptr_t tag_mask = 0x7;
+
+    uintptr_t ptr_tag;
+
+    EventPtr()
+        : ptr_tag( 0 )
+    {}
+
+    EventPtr( EventPtrTag tag, Task * task )
+        : ptr_tag( (uintptr_t)task | tag )
+    {
+        assert( ( (uintptr_t)task & tag_mask ) == 0 );
+    }
+
+    //! takes a reference on `event`
+    explicit EventPtr( ExternalEvent * event );
+
+    EventPtr( EventPtr const & other );
+    EventPtr( EventPtr && other )
+        : ptr_tag( other.ptr_tag )
+    {
+        other.ptr_tag = 0;
+    }
+
+    EventPtr & operator=( EventPtr const & other );
+    EventPtr & operator=( EventPtr && other );
+
+    ~EventPtr();
+
+    inline EventPtrTag get_tag() const
+    {
+        return EventPtrTag( ptr_tag & tag_mask );
+    }
+
+    //! task owning the event, nullptr for external events
+    inline Task * get_task() const
+    {
+        return get_tag() == T_EVT_EXT ? nullptr : (Task *)( ptr_tag & ~tag_mask );
+    }
+
+    inline ExternalEvent * get_external_event() const
+    {
+        return get_tag() == T_EVT_EXT ? (ExternalEvent *)( ptr_tag & ~tag_mask ) : nullptr;
+    }
 
     inline bool operator==( EventPtr const & other ) const
     {
-        return this->tag == other.tag && this->task == other.task;
+        return this->ptr_tag == other.ptr_tag;
     }
 
     Event & get_event() const;
@@ -68,11 +128,105 @@ struct EventPtr
     }
 
     /*! A preceding event was reached and thus an incoming edge got removed.
-     * This events state is decremented and recursively notifies its followers
+     * This events state is decremented and its followers are notified
      * in case it is now also reached.
+     * The propagation runs iteratively on a thread-local worklist,
+     * and all tasks that got ready are activated in one batch
+     * before the outermost notify() returns.
      * @return true if event was ready
      */
     bool notify( bool claimed = false );
+
+private:
+    //! decrement the state, without propagating to the followers
+    bool notify_one( bool claimed );
+
+    //! process the worklist of the current notification wave
+    static void propagate();
+
+    void acquire() const;
+    void release();
+};
+
+static_assert( sizeof( EventPtr ) == sizeof( void * ), "EventPtr has to fit into a pointer" );
+
+/*! Set of followers of an event.
+ *
+ * The first REDGRAPES_EVENT_FOLLOWER_INLINE_SLOTS followers are
+ * stored inline, so most events never allocate.
+ * Further followers spill into a ChunkedList.
+ *
+ * Like ChunkedList, push() and erase() can be called concurrently
+ * and iteration skips followers which are not completely pushed
+ * or already erased. Erased inline slots are not reused,
+ * their EventPtr is kept until the list is destroyed,
+ * so concurrent iterations may still read it.
+ */
+struct FollowerList
+{
+    static constexpr unsigned n_inline = REDGRAPES_EVENT_FOLLOWER_INLINE_SLOTS;
+
+    enum SlotState : uint8_t { SLOT_EMPTY = 0, SLOT_VALID, SLOT_REMOVED };
+
+    FollowerList( memory::Allocator alloc )
+        : n_pushed( 0 )
+        , overflow( std::move( alloc ) )
+    {
+        for( auto & s : slot_states )
+            s.store( SLOT_EMPTY, std::memory_order_relaxed );
+    }
+
+    void push( EventPtr const & follower )
+    {
+        unsigned idx = n_pushed.fetch_add( 1 );
+        if( idx < n_inline )
+        {
+            slots[ idx ] = follower;
+            slot_states[ idx ].store( SLOT_VALID, std::memory_order_release );
+        }
+        else
+            overflow.push( follower );
+    }
+
+    //! remove all occurrences of `follower`
+    void erase( EventPtr const & follower )
+    {
+        for( unsigned i = 0; i < n_used(); ++i )
+        {
+            uint8_t expected = SLOT_VALID;
+            if( slot_states[ i ].load( std::memory_order_acquire ) == SLOT_VALID && slots[ i ] == follower )
+                slot_states[ i ].compare_exchange_strong( expected, SLOT_REMOVED );
+        }
+
+        if( n_pushed.load() > n_inline )
+            overflow.erase( follower );
+    }
+
+    //! call `f( EventPtr & )` for each follower, latest first
+    template < typename F >
+    void for_each( F && f )
+    {
+        if( n_pushed.load() > n_inline )
+            for( auto it = overflow.rbegin(); it != overflow.rend(); ++it )
+                f( *it );
+
+        for( unsigned i = n_used(); i-- > 0; )
+            if( slot_states[ i ].load( std::memory_order_acquire ) == SLOT_VALID )
+                f( slots[ i ] );
+    }
+
+private:
+    unsigned n_used() const
+    {
+        unsigned n = n_pushed.load();
+        return n < n_inline ? n : n_inline;
+    }
+
+    std::array< EventPtr, n_inline > slots;
+    std::array< std::atomic< uint8_t >, n_inline > slot_states;
+    std::atomic< unsigned > n_pushed;
+
+    ChunkedList< EventPtr, REDGRAPES_EVENT_FOLLOWER_LIST_CHUNKSIZE > overflow;
 };
 
 /*!
@@ -98,7 +252,7 @@ struct Event
     WakerId waker_id;
 
     //! the set of subsequent events
-    ChunkedList< EventPtr, REDGRAPES_EVENT_FOLLOWER_LIST_CHUNKSIZE > followers;
+    FollowerList followers;
 
     Event();
     Event(Event &);
@@ -116,6 +270,123 @@ struct Event
     void notify_followers();
 };
 
+struct ExternalEventPool;
+
+/*! Event which is not part of a task, e.g. created by `create_event()`.
+ * It is returned to its pool when the last EventPtr to it is destroyed.
+ */
+struct ExternalEvent : Event
+{
+    std::atomic< unsigned > refcount{ 0 };
+
+    //! pool which owns the memory of this event
+    ExternalEventPool * pool;
+
+    ExternalEvent( ExternalEventPool * pool )
+        : pool( pool )
+    {}
+
+    //! take a new external event from the pool of the current arena
+    static EventPtr create();
+
+    //! called when the last reference is dropped
+    void destroy();
+};
+
+/*! Recycles the memory of the external events of one worker,
+ * so creating an event does not need to allocate in the common case.
+ *
+ * Events can be dropped by any thread, which pushes them onto `returned`
+ * without locking. Threads creating events on this arena take them from
+ * `cached`, which is refilled by grabbing the whole `returned` list at once,
+ * so single nodes are never popped concurrently to pushes (no ABA).
+ * `take_mutex` is only contended when several threads share
+ * an arena, e.g. the main thread and the worker it is bound to.
+ */
+struct ExternalEventPool
+{
+    struct FreeNode
+    {
+        FreeNode * next;
+    };
+
+    memory::ChunkedBumpAlloc< memory::HwlocAlloc > & alloc;
+
+    std::atomic< FreeNode * > returned{ nullptr };
+
+    SpinLock take_mutex;
+    FreeNode * cached = nullptr;
+
+    ExternalEventPool( memory::ChunkedBumpAlloc< memory::HwlocAlloc > & alloc )
+        : alloc( alloc )
+    {}
+
+    ExternalEventPool( ExternalEventPool const & ) = delete;
+
+    //! frees all recycled events, outstanding ones must not be dropped afterwards
+    ~ExternalEventPool();
+
+    //! construct an event in recycled or newly allocated memory
+    ExternalEvent * take();
+
+    //! destroy the event and keep its memory for the next `take()`
+    void put( ExternalEvent * event );
+};
+
+inline EventPtr::EventPtr( ExternalEvent * event )
+    : ptr_tag( (uintptr_t)event | T_EVT_EXT )
+{
+    assert( ( (uintptr_t)event & tag_mask ) == 0 );
+    acquire();
+}
+
+inline EventPtr::EventPtr( EventPtr const & other )
+    : ptr_tag( other.ptr_tag )
+{
+    acquire();
+}
+
+inline EventPtr & EventPtr::operator=( EventPtr const & other )
+{
+    if( this != &other )
+    {
+        other.acquire();
+        release();
+        ptr_tag = other.ptr_tag;
+    }
+    return *this;
+}
+
+inline EventPtr & EventPtr::operator=( EventPtr && other )
+{
+    if( this != &other )
+    {
+        release();
+        ptr_tag = other.ptr_tag;
+        other.ptr_tag = 0;
+    }
+    return *this;
+}
+
+inline EventPtr::~EventPtr()
+{
+    release();
+}
+
+inline void EventPtr::acquire() const
+{
+    if( ExternalEvent * event = get_external_event() )
+        event->refcount.fetch_add( 1, std::memory_order_relaxed );
+}
+
+inline void EventPtr::release()
+{
+    if( ExternalEvent * event = get_external_event() )
+        if( event->refcount.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+            event->destroy();
+    ptr_tag = 0;
+}
+
 } // namespace scheduler
 
 } // namespace redGrapes
@@ -5,8 +5,11 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include <mutex>
 #include <optional>
 
+#include <redGrapes/dispatch/thread/worker_pool.hpp>
+#include <redGrapes/redGrapes.hpp>
 #include <redGrapes/scheduler/event.hpp>
 #include <redGrapes/task/property/graph.hpp>
 #include <redGrapes/task/task.hpp>
@@ -18,7 +21,8 @@ namespace scheduler
 
 Event & EventPtr::get_event() const
     {
-        switch( tag )
+        Task * task = (Task *)( ptr_tag & ~tag_mask );
+        switch( get_tag() )
         {
         case T_EVT_PRE:
             return task->pre_event;
@@ -29,12 +33,65 @@ Event & EventPtr::get_event() const
         case T_EVT_RES_GET:
             return task->result_get_event;
         case T_EVT_EXT:
-            return *external_event;
+            return *get_external_event();
         default:
             throw std::runtime_error("invalid event tag");
         }
     }
 
+EventPtr ExternalEvent::create()
+{
+    auto & ctx = SingletonContext::get();
+    auto & pool = ctx.worker_pool->get_event_pool( ctx.current_arena % ctx.n_workers );
+    return EventPtr( pool.take() );
+}
+
+void ExternalEvent::destroy()
+{
+    pool->put( this );
+}
+
+ExternalEventPool::~ExternalEventPool()
+{
+    FreeNode * node = returned.exchange( nullptr, std::memory_order_acquire );
+    while( cached || node )
+    {
+        if( ! node )
+            std::swap( node, cached );
+
+        FreeNode * next = node->next;
+        alloc.deallocate( memory::Block{ (uintptr_t) node, sizeof( ExternalEvent ) } );
+        node = next;
+    }
+}
+
+ExternalEvent * ExternalEventPool::take()
+{
+    FreeNode * node;
+    {
+        std::unique_lock< SpinLock > lock( take_mutex );
+        if( ! cached )
+            cached = returned.exchange( nullptr, std::memory_order_acquire );
+
+        node = cached;
+        if( node )
+            cached = node->next;
+    }
+
+    void * mem = node ? (void *) node : (void *) alloc.allocate( sizeof( ExternalEvent ) ).ptr;
+    return new ( mem ) ExternalEvent( this );
+}
+
+void ExternalEventPool::put( ExternalEvent * event )
+{
+    event->~ExternalEvent();
+
+    FreeNode * node = new ( (void *) event ) FreeNode;
+    node->next = returned.load( std::memory_order_relaxed );
+    while( ! returned.compare_exchange_weak( node->next, node, std::memory_order_release, std::memory_order_relaxed ) )
+        ;
+}
+
 } // namespace scheduler
 
 } // namespace redGrapes
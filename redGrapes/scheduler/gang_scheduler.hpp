@@ -0,0 +1,278 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/scheduler/gang_scheduler.hpp
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <redGrapes/task/property/gang.hpp>
+#include <redGrapes/scheduler/default_scheduler.hpp>
+#include <redGrapes/redGrapes.hpp>
+
+#include <spdlog/spdlog.h>
+
+namespace redGrapes
+{
+namespace scheduler
+{
+
+/*!
+ * Variant of the DefaultScheduler which runs tasks
+ * with `gang_size = k > 1` on k workers at the same time.
+ *
+ * Ready gang tasks wait in a separate queue until k workers
+ * are AVAILABLE at once, which are then reserved all together
+ * (a partial gang is released again, so that other tasks keep
+ * flowing while the gang is being formed). Each idle worker
+ * retries to form the next gang before it steals.
+ * Rank 0 executes the task itself, the others run copies of its body,
+ * and the post-event of the task is reached when all of them finished.
+ *
+ * Requires `GangProperty` to be part of the task properties.
+ * Gangs are limited to the number of active workers.
+ */
+struct GangScheduler : DefaultScheduler
+{
+    struct Gang
+    {
+        Task * task;
+        GangBarrier barrier;
+        std::vector< std::function< void() > > bodies;
+
+        Gang( Task * task, unsigned size )
+            : task( task )
+            , barrier( size )
+        {}
+    };
+
+    struct Assignment
+    {
+        std::shared_ptr< Gang > gang;
+        unsigned rank;
+    };
+
+    //! ready gang tasks, which wait for enough available workers
+    std::mutex gang_mutex;
+    std::deque< Task * > gang_queue;
+
+    //! size of `gang_queue`, to skip locking while there is no gang task
+    std::atomic< size_t > n_waiting_gangs{ 0 };
+
+    //! gang assignment for each worker, taken in `pop_ready_task()`
+    std::unique_ptr< std::atomic< Assignment * > [] > assignments;
+    size_t n_assignments = 0;
+
+    void init()
+    {
+        DefaultScheduler::init();
+
+        n_assignments = SingletonContext::get().worker_pool->capacity();
+        assignments.reset( new std::atomic< Assignment * >[ n_assignments ] );
+        for( size_t i = 0; i < n_assignments; ++i )
+            assignments[ i ] = nullptr;
+    }
+
+    unsigned get_gang_size( Task const & task )
+    {
+        return std::min( std::max( task.gang_size, 1u ), unsigned( SingletonContext::get().worker_pool->size() ) );
+    }
+
+    /* gang tasks are initialized right away, so they
+     * are not picked up as ready by a single worker
+     */
+    void emplace_task( Task & task )
+    {
+        if( get_gang_size( task ) > 1 )
+            init_task( task );
+        else
+            DefaultScheduler::emplace_task( task );
+    }
+
+    void activate_task( Task & task )
+    {
+        if( get_gang_size( task ) <= 1 )
+            return DefaultScheduler::activate_task( task );
+
+        {
+            std::lock_guard< std::mutex > lock( gang_mutex );
+            gang_queue.push_back( &task );
+            n_waiting_gangs++;
+        }
+
+        try_form_gang();
+    }
+
+    //! one by one, gang tasks have to wait for their workers
+    void activate_tasks( Task ** tasks, size_t n )
+    {
+        IScheduler::activate_tasks( tasks, n );
+    }
+
+    /*! reserve available workers for the oldest waiting gang task
+     * and send each of them its assignment.
+     *
+     * The lock is taken blocking: a worker which becomes available
+     * while another one is probing must probe again afterwards,
+     * otherwise both may see too few workers and the gang never forms.
+     *
+     * @return false if there was no gang task or too few available workers
+     */
+    bool try_form_gang()
+    {
+        if( n_waiting_gangs.load() == 0 )
+            return false;
+
+        std::unique_lock< std::mutex > lock( gang_mutex );
+        if( gang_queue.empty() )
+            return false;
+
+        auto & worker_pool = *SingletonContext::get().worker_pool;
+
+        Task * task = gang_queue.front();
+        unsigned size = get_gang_size( *task );
+
+        unsigned start = 0;
+        if( auto & w = SingletonContext::get().current_worker )
+            start = w->get_worker_id();
+
+        /* a worker may show up as available again before it picked up
+         * its previous assignment, so those are skipped. Assignments
+         * are only written while holding `gang_mutex`.
+         */
+        std::vector< dispatch::thread::WorkerId > members;
+        worker_pool.probe_worker_by_state_linear< unsigned >(
+            [&]( unsigned idx ) -> std::optional< unsigned >
+            {
+                if( idx < n_assignments
+                    && assignments[ idx ].load() == nullptr
+                    && worker_pool.set_worker_state( idx, dispatch::thread::WorkerState::BUSY ) )
+                {
+                    members.push_back( idx );
+                    if( members.size() == size )
+                        return idx;
+                }
+                return std::nullopt;
+            },
+            dispatch::thread::WorkerState::AVAILABLE,
+            start,
+            false );
+
+        if( members.size() < size )
+        {
+            // not enough workers yet, retry when the next one becomes idle
+            for( auto idx : members )
+                worker_pool.set_worker_state( idx, dispatch::thread::WorkerState::AVAILABLE );
+            return false;
+        }
+
+        gang_queue.pop_front();
+        n_waiting_gangs--;
+
+        auto gang = std::make_shared< Gang >( task, size );
+        for( unsigned rank = 1; rank < size; ++rank )
+        {
+            gang->bodies.push_back( task->clone_body() );
+            if( ! gang->bodies.back() )
+            {
+                spdlog::warn("gang task has no copyable body, run it on a single worker");
+
+                for( auto idx : members )
+                    worker_pool.set_worker_state( idx, dispatch::thread::WorkerState::AVAILABLE );
+                lock.unlock();
+
+                DefaultScheduler::activate_task( *task );
+                return false;
+            }
+        }
+
+        // the post-event is reached after all members finished
+        for( unsigned rank = 1; rank < size; ++rank )
+            task->post_event.up();
+
+        for( unsigned rank = 0; rank < size; ++rank )
+            assignments[ members[ rank ] ] = new Assignment{ gang, rank };
+        lock.unlock();
+
+        for( auto idx : members )
+            worker_pool.get_worker( idx ).wake();
+
+        return true;
+    }
+
+    bool has_assignment( dispatch::thread::Worker & worker )
+    {
+        return worker.get_worker_id() < n_assignments
+            && assignments[ worker.get_worker_id() ].load() != nullptr;
+    }
+
+    /* run the part of a gang that was assigned to this worker.
+     * All members have to start together, so it is run right
+     * here instead of being returned, and nullptr is returned.
+     */
+    Task * pop_ready_task( dispatch::thread::Worker & worker )
+    {
+        if( worker.get_worker_id() >= n_assignments )
+            return nullptr;
+
+        std::unique_ptr< Assignment > a( assignments[ worker.get_worker_id() ].exchange( nullptr ) );
+        if( ! a )
+            return nullptr;
+
+        Gang & gang = *a->gang;
+        auto & ctx = SingletonContext::get();
+
+        GangMembership & membership = current_gang();
+        membership = GangMembership{ a->rank, gang.barrier.size, &gang.barrier };
+
+        // start all members together
+        gang.barrier.wait();
+
+        if( a->rank == 0 )
+            ctx.execute_task( *gang.task );
+        else
+        {
+            /* the copies act on behalf of the gang task,
+             * e.g. their child tasks and events belong to it
+             */
+            ctx.current_task = gang.task;
+            worker.stats.tasks_executed.add();
+
+            gang.bodies[ a->rank - 1 ]();
+
+            ctx.current_task = nullptr;
+            gang.task->get_post_event().notify();
+        }
+
+        membership = GangMembership{};
+        return nullptr;
+    }
+
+    /* a gang which this worker is part of is run by
+     * `pop_ready_task()` when it looks for the next task
+     */
+    Task * steal_task( dispatch::thread::Worker & worker )
+    {
+        if( try_form_gang() && has_assignment( worker ) )
+            return nullptr;
+
+        return DefaultScheduler::steal_task( worker );
+    }
+};
+
+} // namespace scheduler
+} // namespace redGrapes
@@ -0,0 +1,152 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/scheduler/priority_scheduler.hpp
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+#include <redGrapes/task/queue.hpp>
+#include <redGrapes/task/property/priority.hpp>
+#include <redGrapes/scheduler/default_scheduler.hpp>
+#include <redGrapes/redGrapes.hpp>
+
+namespace redGrapes
+{
+namespace scheduler
+{
+
+/*!
+ * Variant of the DefaultScheduler which keeps `T_levels`
+ * ready queues per worker, one for each priority level.
+ * Workers always take from the highest non-empty level,
+ * first from their own queues, then by stealing.
+ *
+ * Requires `PriorityProperty` to be part of the task properties.
+ * Priorities outside of [0, T_levels) are clamped.
+ *
+ * New tasks are initialized eagerly by the submitting thread
+ * (see InitMode::EAGER), since a worker which initializes a task
+ * that is ready right away runs it without passing it through
+ * the priority levels. Changing `init_mode` gives up this ordering
+ * for tasks without unfinished predecessors.
+ */
+template < unsigned T_levels = 4 >
+struct PriorityScheduler : DefaultScheduler
+{
+    struct ReadyQueues
+    {
+        std::array< task::Queue, T_levels > levels;
+    };
+
+    //! ready queues for each worker
+    std::vector< std::unique_ptr< ReadyQueues > > ready_queues;
+
+    PriorityScheduler()
+    {
+        init_mode = InitMode::EAGER;
+    }
+
+    static unsigned get_level( Task const & task )
+    {
+        return std::min( unsigned(std::max( task.priority, 0 )), T_levels - 1 );
+    }
+
+    void init()
+    {
+        DefaultScheduler::init();
+
+        ready_queues.clear();
+        for( size_t i = 0; i < SingletonContext::get().worker_pool->capacity(); ++i )
+            ready_queues.emplace_back( new ReadyQueues() );
+    }
+
+    /* push the task into the queue of its priority level
+     * at some worker, preferably an idle one
+     */
+    void activate_task( Task & task )
+    {
+        //! worker id to use in case all workers are busy
+        static thread_local unsigned next_worker = 0;
+
+        TRACE_EVENT("Scheduler", "PriorityScheduler::activate_task");
+        SPDLOG_TRACE("PriorityScheduler::activate_task({}), priority = {}", task.task_id, task.priority);
+
+        auto & worker_pool = *SingletonContext::get().worker_pool;
+
+        int worker_id = worker_pool.find_free_worker();
+        if( worker_id < 0 )
+            worker_id = next_worker++ % worker_pool.size();
+
+        ready_queues[ worker_id ]->levels[ get_level(task) ].push( &task );
+
+        worker_pool.set_worker_state( worker_id, dispatch::thread::WorkerState::BUSY );
+        worker_pool.get_worker( worker_id ).wake();
+    }
+
+    //! one by one, each task goes into the queue of its level
+    void activate_tasks( Task ** tasks, size_t n )
+    {
+        IScheduler::activate_tasks( tasks, n );
+    }
+
+    /* take a task from the highest non-empty level of the own queues
+     */
+    Task * pop_ready_task( dispatch::thread::Worker & worker )
+    {
+        if( worker.get_worker_id() < ready_queues.size() )
+        {
+            auto & levels = ready_queues[ worker.get_worker_id() ]->levels;
+            for( unsigned l = T_levels; l-- > 0; )
+                if( Task * task = levels[ l ].pop() )
+                    return task;
+        }
+
+        return nullptr;
+    }
+
+    /* try to steal from the highest non-empty level of all workers,
+     * before falling back to the queues of the DefaultScheduler
+     */
+    Task * steal_task( dispatch::thread::Worker & worker )
+    {
+        auto & worker_pool = *SingletonContext::get().worker_pool;
+
+        for( unsigned l = T_levels; l-- > 0; )
+        {
+            std::optional< Task * > task = worker_pool.template probe_worker_by_state< Task * >(
+                [this, l]( unsigned idx ) -> std::optional< Task * >
+                {
+                    if( Task * t = ready_queues[ idx ]->levels[ l ].pop() )
+                        return t;
+                    else
+                        return std::nullopt;
+                },
+                dispatch::thread::WorkerState::BUSY,
+                worker.get_worker_id() );
+
+            if( task )
+            {
+                worker_pool.set_worker_state( worker.get_worker_id(), dispatch::thread::WorkerState::BUSY );
+                return *task;
+            }
+        }
+
+        return DefaultScheduler::steal_task( worker );
+    }
+};
+
+} // namespace scheduler
+} // namespace redGrapes
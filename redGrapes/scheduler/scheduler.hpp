@@ -44,14 +44,43 @@ struct IScheduler
         return false;
     }
 
+    //! called once the worker pool is set up, before any worker is started
+    virtual void init() {}
+
+    //! called after the final barrier, before the workers are stopped
+    virtual void finalize() {}
+
     virtual void idle(){}
 
     //! add task to the set of to-initialize tasks
     virtual void emplace_task( Task & task ) {}
 
+    //! add multiple tasks to the set of to-initialize tasks
+    virtual void emplace_tasks( Task ** tasks, size_t n )
+    {
+        for( size_t i = 0; i < n; ++i )
+            emplace_task( *tasks[i] );
+    }
+
     //! add task to ready set
     virtual void activate_task( Task & task ) {}
 
+    //! add multiple tasks, which got ready at once, to the ready set
+    virtual void activate_tasks( Task ** tasks, size_t n )
+    {
+        for( size_t i = 0; i < n; ++i )
+            activate_task( *tasks[i] );
+    }
+
+    /*! give worker a ready task from the queues this scheduler
+     * keeps for it. Called by the worker before it initializes new tasks.
+     * @return task if available, nullptr otherwise
+     */
+    virtual Task * pop_ready_task( dispatch::thread::Worker & worker )
+    {
+        return nullptr;
+    }
+
     //! give worker work if available
     virtual Task * steal_task( dispatch::thread::Worker & worker )
     {
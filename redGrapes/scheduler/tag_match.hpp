@@ -45,6 +45,27 @@ namespace scheduler
                 this->add_scheduler(supported_tags, s);
             }
 
+            void init()
+            {
+                for( auto& s : sub_schedulers )
+                    s.s->init();
+            }
+
+            void finalize()
+            {
+                for( auto& s : sub_schedulers )
+                    s.s->finalize();
+            }
+
+            Task * pop_ready_task( dispatch::thread::Worker & worker )
+            {
+                for( auto& s : sub_schedulers )
+                    if( Task * t = s.s->pop_ready_task( worker ) )
+                        return t;
+
+                return nullptr;
+            }
+
             Task * steal_task( dispatch::thread::Worker & worker )
             {
                 for( auto& s : sub_schedulers )
@@ -54,39 +75,57 @@ namespace scheduler
 		return nullptr;                
             }
 
+            /* the matching sub-scheduler is searched only once,
+             * when the task is emplaced, and cached in the task
+             */
             void emplace_task( Task & task )
             {
-                if(auto sub_scheduler = get_matching_scheduler(task.required_scheduler_tags))
-                    return (*sub_scheduler)->emplace_task(task);
-                else
-                    throw std::runtime_error("no scheduler found for task");                
+                task.sub_scheduler_idx = get_matching_scheduler_idx(task.required_scheduler_tags);
+                get_sub_scheduler(task).emplace_task(task);
             }
 
             void activate_task(Task & task)
             {
-                if(auto sub_scheduler = get_matching_scheduler(task.required_scheduler_tags))
-                    return (*sub_scheduler)->activate_task(task);
-                else
-                    throw std::runtime_error("no scheduler found for task");
+                get_sub_scheduler(task).activate_task(task);
             }
 
             std::optional<std::shared_ptr<IScheduler>> get_matching_scheduler(
                 std::bitset<T_tag_count> const& required_tags)
             {
-                for(auto const& s : sub_schedulers)
-                    if((s.supported_tags & required_tags) == required_tags)
-                        return s.s;
+                int idx = get_matching_scheduler_idx(required_tags);
+                if( idx >= 0 )
+                    return sub_schedulers[idx].s;
+                else
+                    return std::nullopt;
+            }
 
-                return std::nullopt;
+            //! @return index in `sub_schedulers` or -1 if no scheduler matches
+            int get_matching_scheduler_idx(std::bitset<T_tag_count> const& required_tags) const
+            {
+                for(size_t i = 0; i < sub_schedulers.size(); ++i)
+                    if((sub_schedulers[i].supported_tags & required_tags) == required_tags)
+                        return i;
+
+                return -1;
             }
 
-            bool task_dependency_type(Task const & a, Task & b)
+            //! sub-scheduler responsible for the task, as cached in `emplace_task()`
+            IScheduler & get_sub_scheduler(Task const & task)
             {
-                /// fixme: b or a ?
-                if(auto sub_scheduler = get_matching_scheduler(b.required_scheduler_tags))
-                    return (*sub_scheduler)->task_dependency_type(a, b);
-                else
+                int idx = task.sub_scheduler_idx;
+                if( idx < 0 )
+                    idx = get_matching_scheduler_idx(task.required_scheduler_tags);
+
+                if( idx < 0 )
                     throw std::runtime_error("no scheduler found for task");
+
+                return *sub_schedulers[idx].s;
+            }
+
+            bool task_dependency_type(Task const & a, Task const & b)
+            {
+                /// fixme: b or a ?
+                return get_sub_scheduler(b).task_dependency_type(a, b);
             }
 
             void wake_all()
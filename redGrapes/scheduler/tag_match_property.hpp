@@ -14,6 +14,12 @@ namespace redGrapes
         {
             std::bitset<T_tag_count> required_scheduler_tags;
 
+            /*! index of the sub-scheduler of `TagMatch` matching
+             * `required_scheduler_tags`, resolved once when the task
+             * is emplaced. -1 as long as it is not resolved.
+             */
+            int sub_scheduler_idx = -1;
+
             template<typename PropertiesBuilder>
             struct Builder
             {
@@ -34,6 +40,7 @@ namespace redGrapes
                 PropertiesBuilder & scheduling_tags(std::bitset<T_tag_count> tags)
                 {
                     builder.task->required_scheduler_tags |= tags;
+                    builder.task->sub_scheduler_idx = -1;
                     return builder;
                 }
             };
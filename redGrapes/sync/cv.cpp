@@ -1,24 +1,19 @@
 
 #include <redGrapes/sync/cv.hpp>
 
-#include <redGrapes_config.hpp>
-#ifndef REDGRAPES_CONDVAR_TIMEOUT
-#define REDGRAPES_CONDVAR_TIMEOUT 0x200000
-#endif
-
 namespace redGrapes
 {
-    CondVar::CondVar()
-        : CondVar( REDGRAPES_CONDVAR_TIMEOUT )
+    MutexCondVar::MutexCondVar()
+        : MutexCondVar( REDGRAPES_CONDVAR_TIMEOUT )
     {}
 
-    CondVar::CondVar( unsigned timeout )
+    MutexCondVar::MutexCondVar( unsigned timeout )
         : should_wait( true )
         , timeout(timeout)
     {
     }
 
-    void CondVar::wait()
+    void MutexCondVar::wait()
     {
         unsigned count = 0;
         while( should_wait.load(std::memory_order_acquire) )
@@ -39,7 +34,7 @@ namespace redGrapes
         should_wait.store(true);
     }
 
-    bool CondVar::notify()
+    bool MutexCondVar::notify()
     {
         bool w = true;
         should_wait.compare_exchange_strong(w, false, std::memory_order_release);
@@ -4,6 +4,23 @@
 #include <atomic>
 #include <condition_variable>
 #include <redGrapes/sync/spinlock.hpp>
+#include <redGrapes/sync/futex_cv.hpp>
+
+#include <redGrapes_config.hpp>
+#ifndef REDGRAPES_CONDVAR_TIMEOUT
+#define REDGRAPES_CONDVAR_TIMEOUT 0x200000
+#endif
+
+/* use the futex-based FutexCondVar as CondVar where available,
+ * otherwise fall back to MutexCondVar
+ */
+#ifndef REDGRAPES_CONDVAR_FUTEX
+#if REDGRAPES_HAS_FUTEX
+#define REDGRAPES_CONDVAR_FUTEX 1
+#else
+#define REDGRAPES_CONDVAR_FUTEX 0
+#endif
+#endif
 
 namespace redGrapes
 {
@@ -14,7 +31,10 @@ struct PhantomLock
     inline void unlock() {}
 };
 
-struct CondVar
+/* busy-waits for `timeout` iterations
+ * and then sleeps on a std::condition_variable
+ */
+struct MutexCondVar
 {
     std::atomic<bool> should_wait;
     std::condition_variable cv;
@@ -25,12 +45,18 @@ struct CondVar
 
     unsigned timeout;
 
-    CondVar();
-    CondVar( unsigned timeout );
+    MutexCondVar();
+    MutexCondVar( unsigned timeout );
         
     void wait();
     bool notify();
 };
 
+#if REDGRAPES_CONDVAR_FUTEX
+using CondVar = FutexCondVar;
+#else
+using CondVar = MutexCondVar;
+#endif
+
 } // namespace redGrapes
 
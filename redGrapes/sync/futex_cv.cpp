@@ -0,0 +1,139 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <redGrapes/sync/cv.hpp>
+
+#if REDGRAPES_HAS_FUTEX
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <redGrapes/util/trace.hpp>
+
+//! initial and minimal number of spin iterations
+#ifndef REDGRAPES_FUTEX_MIN_SPIN
+#define REDGRAPES_FUTEX_MIN_SPIN 0x100
+#endif
+
+//! maximal number of pause instructions between two polls
+#ifndef REDGRAPES_FUTEX_MAX_BACKOFF
+#define REDGRAPES_FUTEX_MAX_BACKOFF 64
+#endif
+
+/* a parked wait shorter than this is considered as
+ * "almost hit", so the spin budget is increased
+ */
+#ifndef REDGRAPES_FUTEX_SHORT_WAIT_NS
+#define REDGRAPES_FUTEX_SHORT_WAIT_NS 50000
+#endif
+
+namespace redGrapes
+{
+
+static inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+static inline void futex_wait( std::atomic< uint32_t > * addr, uint32_t expected )
+{
+    syscall( SYS_futex, (uint32_t*)addr, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0 );
+}
+
+static inline void futex_wake( std::atomic< uint32_t > * addr )
+{
+    syscall( SYS_futex, (uint32_t*)addr, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0 );
+}
+
+FutexCondVar::FutexCondVar()
+    : FutexCondVar( REDGRAPES_CONDVAR_TIMEOUT )
+{}
+
+FutexCondVar::FutexCondVar( unsigned timeout )
+    : state( EMPTY )
+    , timeout( timeout )
+    , spin_budget( REDGRAPES_FUTEX_MIN_SPIN )
+{
+}
+
+/* take the notification if there is one
+ */
+inline bool FutexCondVar::try_consume()
+{
+    uint32_t s = NOTIFIED;
+    return state.load( std::memory_order_relaxed ) == NOTIFIED
+        && state.compare_exchange_strong( s, EMPTY, std::memory_order_acquire, std::memory_order_relaxed );
+}
+
+/* sleep until notified, other waiters may have
+ * consumed the notification when we wake up
+ */
+void FutexCondVar::park()
+{
+    TRACE_EVENT("CondVar", "park");
+    while( ! try_consume() )
+    {
+        uint32_t s = EMPTY;
+        if( state.compare_exchange_strong( s, PARKED, std::memory_order_relaxed ) || s == PARKED )
+            futex_wait( &state, PARKED );
+    }
+}
+
+void FutexCondVar::wait()
+{
+    unsigned budget = std::min( spin_budget, timeout );
+    unsigned backoff = 1;
+
+    for( unsigned count = 0; count < budget; count += backoff )
+    {
+        if( try_consume() )
+        {
+            // notification arrived while spinning, keep enough budget for the next time
+            spin_budget = std::max( spin_budget, std::min( 2 * count, timeout ) );
+            return;
+        }
+
+        for( unsigned i = 0; i < backoff; ++i )
+            cpu_relax();
+
+        if( backoff < REDGRAPES_FUTEX_MAX_BACKOFF )
+            backoff *= 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    park();
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    if( duration < std::chrono::nanoseconds( REDGRAPES_FUTEX_SHORT_WAIT_NS ) )
+        spin_budget = std::min( 2 * std::max( spin_budget, 1u ), std::max( timeout, 1u ) );
+    else
+        spin_budget = std::max( spin_budget / 2, (unsigned) REDGRAPES_FUTEX_MIN_SPIN );
+}
+
+bool FutexCondVar::notify()
+{
+    uint32_t s = state.exchange( NOTIFIED, std::memory_order_release );
+
+    if( s == PARKED )
+        futex_wake( &state );
+
+    return s != NOTIFIED;
+}
+
+} // namespace redGrapes
+
+#endif
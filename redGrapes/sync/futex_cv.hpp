@@ -0,0 +1,74 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/sync/futex_cv.hpp
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(__linux__)
+#define REDGRAPES_HAS_FUTEX 1
+#else
+#define REDGRAPES_HAS_FUTEX 0
+#endif
+
+#if REDGRAPES_HAS_FUTEX
+
+namespace redGrapes
+{
+
+/* Condition variable with the same interface as MutexCondVar,
+ * parking the waiting thread on a linux futex.
+ *
+ * `wait()` first spins for an adaptive number of iterations
+ * (at most `timeout`), which is learned from the duration of
+ * previous waits: if the notification came while spinning or
+ * shortly after parking, spinning pays off and the budget grows,
+ * if the thread slept for long, the budget shrinks.
+ *
+ * `notify()` only issues a syscall if the waiter is actually parked.
+ *
+ * As with MutexCondVar, a notification which arrives before
+ * `wait()` is not lost, but lets the next `wait()` return immediately.
+ */
+struct FutexCondVar
+{
+    enum State : uint32_t
+    {
+        EMPTY = 0,
+        NOTIFIED = 1,
+        PARKED = 2
+    };
+
+    alignas(64) std::atomic< uint32_t > state;
+
+    //! maximal number of spin iterations before parking
+    unsigned timeout;
+
+    //! current number of spin iterations, only touched by the waiting thread
+    unsigned spin_budget;
+
+    FutexCondVar();
+    FutexCondVar( unsigned timeout );
+
+    void wait();
+    bool notify();
+
+private:
+    bool try_consume();
+    void park();
+};
+
+} // namespace redGrapes
+
+#endif
@@ -0,0 +1,244 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/task/parallel_for.hpp
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <redGrapes/redGrapes.hpp>
+#include <redGrapes/resource/fieldresource.hpp>
+
+#ifndef REDGRAPES_PARALLEL_FOR_CHUNKS_PER_WORKER
+#define REDGRAPES_PARALLEL_FOR_CHUNKS_PER_WORKER 4
+#endif
+
+#ifndef REDGRAPES_PARALLEL_FOR_LAZY_STEPS_PER_WORKER
+#define REDGRAPES_PARALLEL_FOR_LAZY_STEPS_PER_WORKER 16
+#endif
+
+namespace redGrapes
+{
+
+namespace detail
+{
+
+//! call `f( index )` for each index in `[begin, end)`, first dimension fastest
+template < typename Index, typename F >
+void for_each_index( Index const & begin, Index const & end, F && f )
+{
+    for( size_t d = 0; d < begin.size(); ++d )
+        if( end[d] <= begin[d] )
+            return;
+
+    Index index = begin;
+    while( true )
+    {
+        f( index );
+
+        size_t d = 0;
+        for( ; d < index.size(); ++d )
+        {
+            if( ++index[d] < end[d] )
+                break;
+            index[d] = begin[d];
+        }
+
+        if( d == index.size() )
+            return;
+    }
+}
+
+/* body of the tasks created by `parallel_for_lazy()`,
+ * which processes its range in steps of `grain`
+ * and splits off the upper half of the remaining range as new task
+ * whenever a worker is available
+ */
+template < typename Guard, typename Body >
+struct LazyLoop
+{
+    using Index = typename Guard::Index;
+    static constexpr size_t split_dim = Guard::dim - 1;
+
+    Body body;
+    size_t grain;
+
+    void operator() ( Guard sub_guard, Index begin, Index end )
+    {
+        auto & worker_pool = *SingletonContext::get().worker_pool;
+
+        while( begin[split_dim] < end[split_dim] )
+        {
+            size_t remaining = end[split_dim] - begin[split_dim];
+
+            /* at most one split per step, since the available
+             * worker shows up as busy only after it took the new task
+             */
+            if( remaining >= 2 * grain && worker_pool.has_available_worker() )
+            {
+                Index mid = end;
+                mid[split_dim] = begin[split_dim] + remaining / 2;
+
+                emplace_task( *this, sub_guard.area( mid, end ), mid, end );
+
+                end = mid;
+                remaining = end[split_dim] - begin[split_dim];
+            }
+
+            Index step_end = end;
+            step_end[split_dim] = begin[split_dim] + std::min( grain, remaining );
+
+            for_each_index( begin, step_end, [&]( Index const & index ) { body( sub_guard, index ); } );
+
+            begin[split_dim] = step_end[split_dim];
+        }
+    }
+};
+
+} // namespace detail
+
+/*! Data-parallel loop over an area of a field resource.
+ *
+ * The index range `[range.first, range.second)` is split along its
+ * last dimension (the outermost one of the `trait::Field` layouts)
+ * into chunks, and one task is emplaced for each chunk.
+ * Each task accesses only the sub-area `guard.area(...)` of its chunk
+ * (with the access mode of `guard`, i.e. read or write),
+ * so tasks on other parts of the field are not serialized against it.
+ *
+ * `body( sub_guard, index )` is called for every index of the chunk,
+ * where `sub_guard` may only be used inside of the chunk.
+ *
+ * The number of chunks adapts to the number of workers
+ * (REDGRAPES_PARALLEL_FOR_CHUNKS_PER_WORKER for each worker).
+ * `grain` is a lower bound for the chunk size along the split dimension,
+ * it can make chunks coarser but never finer than this default.
+ *
+ * The results of the tasks are discarded, subsequent tasks
+ * which access the field are ordered after them as usual.
+ *
+ * @param guard  ReadGuard or WriteGuard of a FieldResource, e.g. `field.write()`
+ * @param range  begin and end index of the iteration space
+ * @param body   callable, copied into each task
+ * @param grain  minimum chunk size, 0 for automatic
+ */
+template < typename Guard, typename Body >
+void parallel_for(
+    Guard const & guard,
+    std::pair< typename Guard::Index, typename Guard::Index > range,
+    Body && body,
+    size_t grain = 0 )
+{
+    using Index = typename Guard::Index;
+    constexpr size_t dim = Guard::dim;
+    constexpr size_t split_dim = dim - 1;
+
+    Index begin = range.first;
+    Index end = range.second;
+
+    for( size_t d = 0; d < dim; ++d )
+        if( end[d] <= begin[d] )
+            return;
+
+    size_t extent = end[split_dim] - begin[split_dim];
+    size_t max_chunks = REDGRAPES_PARALLEL_FOR_CHUNKS_PER_WORKER * SingletonContext::get().worker_pool->size();
+
+    size_t n_chunks = max_chunks;
+    if( grain > 0 )
+        n_chunks = std::min( n_chunks, ( extent + grain - 1 ) / grain );
+    n_chunks = std::max< size_t >( std::min( n_chunks, extent ), 1 );
+
+    // distribute the remainder over the first chunks
+    std::vector< std::pair< Index, Index > > chunks;
+    chunks.reserve( n_chunks );
+    size_t pos = begin[split_dim];
+    for( size_t i = 0; i < n_chunks; ++i )
+    {
+        size_t len = extent / n_chunks + ( i < extent % n_chunks ? 1 : 0 );
+
+        Index chunk_begin = begin;
+        Index chunk_end = end;
+        chunk_begin[split_dim] = pos;
+        chunk_end[split_dim] = pos + len;
+        chunks.emplace_back( chunk_begin, chunk_end );
+
+        pos += len;
+    }
+
+    emplace_tasks(
+        chunks,
+        [body = std::forward< Body >( body )]( auto sub_guard, Index chunk_begin, Index chunk_end ) mutable
+        {
+            detail::for_each_index( chunk_begin, chunk_end, [&]( Index const & index ) { body( sub_guard, index ); } );
+        },
+        [&guard]( std::pair< Index, Index > const & chunk )
+        {
+            return std::make_tuple( guard.area( chunk.first, chunk.second ), chunk.first, chunk.second );
+        } );
+}
+
+/*! Data-parallel loop like `parallel_for()`, but with lazy splitting.
+ *
+ * Instead of creating all chunks upfront, a single task covers the
+ * whole range and processes it in steps of `grain`. Before each step
+ * it checks the worker pool: if some worker is AVAILABLE (idle or
+ * trying to steal), the upper half of the remaining range is split off
+ * as a new task with the corresponding sub-area access.
+ * New tasks split further in the same way, so a saturated machine
+ * executes only few large tasks while idle workers still get work.
+ *
+ * @param guard  ReadGuard or WriteGuard of a FieldResource, e.g. `field.write()`
+ * @param range  begin and end index of the iteration space
+ * @param body   callable `body( sub_guard, index )`, copied into each task
+ * @param grain  number of elements along the split dimension between
+ *               two checks, which is also the minimum task size.
+ *               0 chooses REDGRAPES_PARALLEL_FOR_LAZY_STEPS_PER_WORKER
+ *               steps for each worker.
+ */
+template < typename Guard, typename Body >
+void parallel_for_lazy(
+    Guard const & guard,
+    std::pair< typename Guard::Index, typename Guard::Index > range,
+    Body && body,
+    size_t grain = 0 )
+{
+    using Index = typename Guard::Index;
+    constexpr size_t split_dim = Guard::dim - 1;
+
+    Index begin = range.first;
+    Index end = range.second;
+
+    for( size_t d = 0; d < Guard::dim; ++d )
+        if( end[d] <= begin[d] )
+            return;
+
+    if( grain == 0 )
+    {
+        size_t extent = end[split_dim] - begin[split_dim];
+        size_t steps = REDGRAPES_PARALLEL_FOR_LAZY_STEPS_PER_WORKER * SingletonContext::get().worker_pool->size();
+        grain = std::max< size_t >( extent / steps, 1 );
+    }
+
+    // e.g. a FieldResource passed as guard yields a WriteGuard
+    using SubGuard = decltype( guard.area( begin, end ) );
+
+    emplace_task(
+        detail::LazyLoop< SubGuard, std::decay_t< Body > >{ std::forward< Body >( body ), grain },
+        guard.area( begin, end ),
+        begin,
+        end );
+}
+
+} // namespace redGrapes
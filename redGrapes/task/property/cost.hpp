@@ -0,0 +1,115 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/task/property/cost.hpp
+ */
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <fmt/format.h>
+#include <redGrapes/sync/spinlock.hpp>
+#include <redGrapes/memory/allocator.hpp>
+#include <redGrapes/task/property/graph.hpp>
+
+namespace redGrapes
+{
+
+/*! Estimated cost of a task (in arbitrary, but consistent units)
+ * together with the length of the longest path from this task
+ * to the end of the known task-graph (bottom-level),
+ * which is maintained by the `CriticalPathScheduler`.
+ */
+struct CostProperty
+{
+    //! estimated cost of this task alone
+    float cost = 1.0;
+
+    //! estimated cost of the longest path starting at this task
+    mutable std::atomic< float > bottom_level{ 1.0 };
+
+    /*! predecessors which were not finished when the edge was created.
+     * They are pinned, so the bottom-level can be propagated
+     * through them as long as this task is not ready.
+     */
+    mutable SpinLock predecessors_mutex;
+    mutable std::vector< GraphProperty *, memory::StdAllocator< GraphProperty * > > predecessors;
+
+    CostProperty() = default;
+
+    //! copies only the estimate, e.g. when a recorded task is replayed
+    CostProperty & operator=( CostProperty const & other )
+    {
+        cost = other.cost;
+        bottom_level = other.cost;
+        return *this;
+    }
+
+    ~CostProperty()
+    {
+        for( GraphProperty * p : predecessors )
+            p->unpin();
+    }
+
+    template < typename TaskBuilder >
+    struct Builder
+    {
+        TaskBuilder & builder;
+
+        Builder( TaskBuilder & builder )
+            : builder(builder)
+        {}
+
+        TaskBuilder & cost( float c )
+        {
+            builder.task->cost = c;
+            builder.task->bottom_level = c;
+            return builder;
+        }
+    };
+
+    struct Patch
+    {
+        template <typename PatchBuilder>
+        struct Builder
+        {
+            Builder( PatchBuilder & ) {}
+        };
+    };
+
+    void apply_patch( Patch const & ) {}
+};
+
+} // namespace redGrapes
+
+template <>
+struct fmt::formatter< redGrapes::CostProperty >
+{
+    constexpr auto parse( format_parse_context& ctx )
+    {
+        return ctx.begin();
+    }
+
+    template < typename FormatContext >
+    auto format(
+        redGrapes::CostProperty const & cost_prop,
+        FormatContext & ctx
+    )
+    {
+        return format_to(
+                   ctx.out(),
+                   "\"cost\" : {}, \"bottom_level\" : {}",
+                   cost_prop.cost,
+                   cost_prop.bottom_level.load()
+               );
+    }
+};
+
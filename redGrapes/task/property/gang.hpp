@@ -0,0 +1,145 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/task/property/gang.hpp
+ */
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <fmt/format.h>
+
+namespace redGrapes
+{
+
+/*! Requests `gang_size` workers at the same time for a task,
+ * e.g. for internally parallel kernels.
+ * The task body is started on all workers of the gang together,
+ * where it can use `gang_rank()`, `gang_size()` and `gang_barrier()`.
+ * Only the invocation with rank 0 sets the result of the task.
+ *
+ * Requires a scheduler which supports gangs (see GangScheduler).
+ */
+struct GangProperty
+{
+    unsigned gang_size = 1;
+
+    template < typename TaskBuilder >
+    struct Builder
+    {
+        TaskBuilder & builder;
+
+        Builder( TaskBuilder & builder )
+            : builder(builder)
+        {}
+
+        TaskBuilder & gang( unsigned k )
+        {
+            builder.task->gang_size = k;
+            return builder;
+        }
+    };
+
+    struct Patch
+    {
+        template <typename PatchBuilder>
+        struct Builder
+        {
+            Builder( PatchBuilder & ) {}
+        };
+    };
+
+    void apply_patch( Patch const & ) {}
+};
+
+/*! barrier for a fixed number of threads, which spins
+ * since all members of a gang run concurrently anyway
+ */
+struct GangBarrier
+{
+    unsigned const size;
+    std::atomic< unsigned > count{ 0 };
+    std::atomic< unsigned > generation{ 0 };
+
+    GangBarrier( unsigned size )
+        : size( size )
+    {}
+
+    void wait()
+    {
+        unsigned gen = generation.load( std::memory_order_acquire );
+        if( count.fetch_add( 1, std::memory_order_acq_rel ) + 1 == size )
+        {
+            count.store( 0, std::memory_order_relaxed );
+            generation.fetch_add( 1, std::memory_order_release );
+        }
+        else
+            while( generation.load( std::memory_order_acquire ) == gen )
+                std::this_thread::yield();
+    }
+};
+
+//! membership of the calling thread in a running gang
+struct GangMembership
+{
+    unsigned rank = 0;
+    unsigned size = 1;
+    GangBarrier * barrier = nullptr;
+};
+
+inline GangMembership & current_gang()
+{
+    static thread_local GangMembership membership;
+    return membership;
+}
+
+//! rank of the calling worker in the gang of the current task, 0 if not in a gang
+inline unsigned gang_rank()
+{
+    return current_gang().rank;
+}
+
+//! number of workers in the gang of the current task, 1 if not in a gang
+inline unsigned gang_size()
+{
+    return current_gang().size;
+}
+
+//! wait until all workers of the current gang arrived here
+inline void gang_barrier()
+{
+    if( GangBarrier * barrier = current_gang().barrier )
+        barrier->wait();
+}
+
+} // namespace redGrapes
+
+template <>
+struct fmt::formatter< redGrapes::GangProperty >
+{
+    constexpr auto parse( format_parse_context& ctx )
+    {
+        return ctx.begin();
+    }
+
+    template < typename FormatContext >
+    auto format(
+        redGrapes::GangProperty const & gang_prop,
+        FormatContext & ctx
+    )
+    {
+        return format_to(
+                   ctx.out(),
+                   "\"gang_size\" : {}",
+                   gang_prop.gang_size
+               );
+    }
+};
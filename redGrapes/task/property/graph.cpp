@@ -23,9 +23,9 @@ namespace redGrapes
  */
 scheduler::EventPtr GraphProperty::make_event()
 {
-    auto event = memory::alloc_shared< scheduler::Event >();
+    scheduler::EventPtr event = scheduler::ExternalEvent::create();
     event->add_follower( get_post_event() );
-    return scheduler::EventPtr{ scheduler::T_EVT_EXT, nullptr, event };
+    return event;
 }
 
 /*!
@@ -76,12 +76,7 @@ void GraphProperty::init_graph()
         }
     }
 
-    // add dependency to parent
-    if( auto parent = this->space->parent )
-    {
-        SPDLOG_TRACE("add event dep to parent");
-        this->post_event.add_follower( parent->get_post_event() );
-    }
+    // the dependency to the parent was already added in TaskSpace::add_task()
 }
 
 void GraphProperty::delete_from_resources()
@@ -98,6 +93,17 @@ void GraphProperty::delete_from_resources()
     }
 }
 
+void GraphProperty::pin()
+{
+    task->removal_countdown++;
+}
+
+void GraphProperty::unpin()
+{
+    if( task->removal_countdown.fetch_sub(1) == 1 )
+        space->free_task( task );
+}
+
 void GraphProperty::add_dependency( Task & preceding_task )
 {
     // precedence graph
@@ -117,12 +123,12 @@ void GraphProperty::update_graph( )
     //std::unique_lock< SpinLock > lock( post_event.followers_mutex );
 
     //    for( auto follower : post_event.followers )
-    for( auto it = post_event.followers.rbegin(); it != post_event.followers.rend(); ++it )
+    post_event.followers.for_each( [this]( scheduler::EventPtr & f )
     {
-        scheduler::EventPtr follower = *it;
-        if( follower.task )
+        scheduler::EventPtr follower = f;
+        if( Task * follower_task = follower.get_task() )
         {
-            if( ! space->is_serial(*this->task, *follower.task) )
+            if( ! space->is_serial(*this->task, *follower_task) )
             {
                 // remove dependency
                 //follower.task->in_edges.erase(std::find(std::begin(follower.task->in_edges), std::end(follower.task->in_edges), this));
@@ -131,7 +137,7 @@ void GraphProperty::update_graph( )
                 follower.notify();
             }
         }
-    }
+    });
 }
 
 } // namespace redGrapes
@@ -155,6 +155,20 @@ struct GraphProperty
      */
     void delete_from_resources();
 
+    /*!
+     * keep this task alive until the corresponding `unpin()`,
+     * even if its post- and result-get-events are reached.
+     * Must only be called while the task can not be freed concurrently,
+     * e.g. while holding the users-mutex of one of its resources.
+     */
+    void pin();
+
+    /*!
+     * release a reference taken by `pin()`, and free the task
+     * if it was the last one
+     */
+    void unpin();
+
     template < typename PropertiesBuilder >
     struct Builder
     {
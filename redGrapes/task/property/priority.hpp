@@ -0,0 +1,81 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/task/property/priority.hpp
+ */
+
+#pragma once
+
+#include <fmt/format.h>
+
+namespace redGrapes
+{
+
+/*! Hint for schedulers which tasks to prefer
+ * when multiple tasks are ready, e.g. to advance
+ * the critical path first.
+ * Higher values mean higher priority.
+ */
+struct PriorityProperty
+{
+    int priority = 0;
+
+    template < typename TaskBuilder >
+    struct Builder
+    {
+        TaskBuilder & builder;
+
+        Builder( TaskBuilder & builder )
+            : builder(builder)
+        {}
+
+        TaskBuilder & priority( int p )
+        {
+            builder.task->priority = p;
+            return builder;
+        }
+    };
+
+    struct Patch
+    {
+        template <typename PatchBuilder>
+        struct Builder
+        {
+            Builder( PatchBuilder & ) {}
+        };
+    };
+
+    void apply_patch( Patch const & ) {}
+};
+
+} // namespace redGrapes
+
+template <>
+struct fmt::formatter< redGrapes::PriorityProperty >
+{
+    constexpr auto parse( format_parse_context& ctx )
+    {
+        return ctx.begin();
+    }
+
+    template < typename FormatContext >
+    auto format(
+        redGrapes::PriorityProperty const & prio_prop,
+        FormatContext & ctx
+    )
+    {
+        return format_to(
+                   ctx.out(),
+                   "\"priority\" : {}",
+                   prio_prop.priority
+               );
+    }
+};
+
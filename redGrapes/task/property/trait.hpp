@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <array>
 #include <typeinfo>
 #include <boost/core/demangle.hpp>
 
@@ -79,6 +80,29 @@ struct BuildProperties< unsigned int >
     {}
 };
 
+template <>
+struct BuildProperties< unsigned long >
+{
+    template <typename Builder>
+    inline static void build(Builder & builder, unsigned long const & t)
+    {}
+};
+
+// e.g. indices
+template <
+    typename T,
+    size_t N
+>
+struct BuildProperties< std::array< T, N > >
+{
+    template <typename Builder>
+    inline static void build(Builder & builder, std::array< T, N > const & a)
+    {
+        for( auto const & x : a )
+            BuildProperties< T >::build( builder, x );
+    }
+};
+
 } // namespace trait
 
 } // namespace redGrapes
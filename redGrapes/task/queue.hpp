@@ -8,10 +8,12 @@
 #pragma once
 
 #include <mutex>
+#include <type_traits>
 #include <redGrapes/memory/block.hpp>
 #include <redGrapes/memory/allocator.hpp>
 #include <moodycamel/concurrentqueue.h>
 #include <redGrapes/util/trace.hpp>
+#include <redGrapes/util/chase_lev_deque.hpp>
 
 namespace redGrapes
 {
@@ -126,6 +128,12 @@ struct Queue
         this->cq.enqueue(task);
     }
 
+    inline void push_bulk(Task ** tasks, size_t n)
+    {
+        TRACE_EVENT("Task", "TaskQueue::push_bulk()");
+        this->cq.enqueue_bulk(tasks, n);
+    }
+
     inline Task * pop()
     {
         TRACE_EVENT("Task", "TaskQueue::pop()");
@@ -135,7 +143,122 @@ struct Queue
         else
             return nullptr;
     }
+
+    /* the FIFO queue has no distinguished owner,
+     * so thieves and the local worker are treated equally
+     */
+    inline void push_local(Task * task)
+    {
+        push( task );
+    }
+
+    inline Task * steal()
+    {
+        return pop();
+    }
+
+    //! take up to `n` tasks at once, @return number of tasks taken
+    inline size_t steal_bulk(Task ** tasks, size_t n)
+    {
+        TRACE_EVENT("Task", "TaskQueue::steal_bulk()");
+        return this->cq.try_dequeue_bulk(tasks, n);
+    }
+
+    inline size_t size_approx() const
+    {
+        return this->cq.size_approx();
+    }
 };
 
+/* Ready-queue for a single worker, built on a Chase-Lev deque.
+ *
+ * The owning worker pushes and pops LIFO at the bottom end,
+ * so it continues with the most recently activated (and thus
+ * most likely cache-hot) task, while thieves take FIFO
+ * from the top end and get the oldest task.
+ *
+ * Since tasks are also activated by foreign threads,
+ * which must not touch the bottom end of the deque,
+ * `push()` goes to a separate multi-producer inbox
+ * which is drained by both, the owner and thieves.
+ */
+struct WorkStealingQueue
+{
+    ChaseLevDeque< Task * > deque;
+    Queue inbox;
+
+    WorkStealingQueue( unsigned capacity )
+        : deque( capacity )
+        , inbox( capacity )
+    {}
+
+    //! may be called by any thread
+    inline void push(Task * task)
+    {
+        inbox.push( task );
+    }
+
+    //! may only be called by the owning worker
+    inline void push_local(Task * task)
+    {
+        TRACE_EVENT("Task", "WorkStealingQueue::push_local()");
+        deque.push( task );
+    }
+
+    //! may only be called by the owning worker
+    inline Task * pop()
+    {
+        TRACE_EVENT("Task", "WorkStealingQueue::pop()");
+        if( Task * t = deque.pop() )
+            return t;
+        else
+            return inbox.pop();
+    }
+
+    //! may be called by any thread
+    inline Task * steal()
+    {
+        TRACE_EVENT("Task", "WorkStealingQueue::steal()");
+        if( Task * t = deque.steal() )
+            return t;
+        else
+            return inbox.pop();
+    }
+
+    //! may be called by any thread, @return number of tasks taken
+    inline size_t steal_bulk(Task ** tasks, size_t n)
+    {
+        TRACE_EVENT("Task", "WorkStealingQueue::steal_bulk()");
+        size_t k = 0;
+        while( k < n && (tasks[k] = deque.steal()) )
+            ++k;
+
+        if( k < n )
+            k += inbox.steal_bulk( tasks + k, n - k );
+
+        return k;
+    }
+
+    inline size_t size_approx() const
+    {
+        return deque.size() + inbox.size_approx();
+    }
+};
+
+/* select the queue implementation used for ready tasks
+ * of each worker:
+ *   0: FIFO queue (moodycamel::ConcurrentQueue)
+ *   1: LIFO work-stealing deque (Chase-Lev)
+ */
+#ifndef REDGRAPES_READY_QUEUE_CHASE_LEV
+#define REDGRAPES_READY_QUEUE_CHASE_LEV 0
+#endif
+
+using ReadyQueue = std::conditional_t<
+    REDGRAPES_READY_QUEUE_CHASE_LEV,
+    WorkStealingQueue,
+    Queue
+>;
+
 }
 }
@@ -6,7 +6,11 @@
  */
 #pragma once
 
+#include <functional>
+#include <stdexcept>
 #include <type_traits>
+#include <vector>
+#include <redGrapes/memory/allocator.hpp>
 #include <redGrapes/task/task_base.hpp>
 #include <redGrapes/task/property/inherit.hpp>
 #include <redGrapes/task/property/trait.hpp>
@@ -32,6 +36,29 @@ using TaskProperties = TaskProperties1<
 #endif
 >;
 
+namespace detail
+{
+
+//! copy the given properties from one task to another
+template < typename... Properties >
+struct CopyProperties
+{
+    static void copy( TaskProperties & dst, TaskProperties const & src )
+    {
+        int dummy[] = { 0, ( static_cast< Properties & >( dst ) = static_cast< Properties const & >( src ), 0 )... };
+        (void) dummy;
+    }
+};
+
+//! properties which are set by the user and can be copied as a whole
+#ifdef REDGRAPES_TASK_PROPERTIES
+using CopyUserProperties = CopyProperties< REDGRAPES_TASK_PROPERTIES >;
+#else
+using CopyUserProperties = CopyProperties<>;
+#endif
+
+} // namespace detail
+
 struct Task :
         TaskBase,
         TaskProperties
@@ -49,6 +76,25 @@ struct Task :
     {
         return nullptr;
     }
+
+    /*! independent copy of the task body, whose result is discarded,
+     * used to run the body on multiple workers (see GangProperty).
+     * Empty if the body can not be copied.
+     */
+    virtual std::function< void() > clone_body()
+    {
+        return {};
+    }
+
+    /*! new task with the same properties and a copy of the body,
+     * allocated on the current arena but not submitted yet
+     * (used to replay a recorded TaskGraph).
+     * nullptr if the body can not be copied.
+     */
+    virtual Task * clone()
+    {
+        return nullptr;
+    }
 };
 
 // TODO: fuse ResultTask and FunTask into one template
@@ -101,6 +147,71 @@ struct FunTask
     {
         return (*this->impl)();
     }
+
+    std::function< void() > clone_body()
+    {
+        return clone_body( std::is_copy_constructible< F >{} );
+    }
+
+    Task * clone()
+    {
+        return clone( std::is_copy_constructible< F >{} );
+    }
+
+private:
+    struct CloneBuilder : TaskProperties::Builder< CloneBuilder >
+    {
+        FunTask * task;
+
+        CloneBuilder( FunTask * task )
+            : TaskProperties::Builder< CloneBuilder >( *this )
+            , task( task )
+        {}
+    };
+
+    Task * clone( std::true_type )
+    {
+        memory::Allocator alloc;
+        memory::Block blk = alloc.allocate( sizeof(FunTask) );
+        FunTask * task = (FunTask *)blk.ptr;
+
+        if( ! task )
+            throw std::runtime_error("out of memory");
+
+        new (task) FunTask();
+        task->arena_id = alloc.worker_id;
+        task->enable_stack_switching = this->enable_stack_switching;
+
+        CloneBuilder builder( task );
+        builder.init_id();
+
+        // access list is iterated backwards, keep the original order
+        std::vector< ResourceAccess > accesses;
+        for( auto ra = this->access_list.rbegin(); ra != this->access_list.rend(); ++ra )
+            accesses.push_back( *ra );
+        for( auto ra = accesses.rbegin(); ra != accesses.rend(); ++ra )
+            builder.add_resource( *ra );
+
+        detail::CopyUserProperties::copy( *task, *this );
+
+        task->impl.emplace( *this->impl );
+        return task;
+    }
+
+    Task * clone( std::false_type )
+    {
+        return nullptr;
+    }
+
+    std::function< void() > clone_body( std::true_type )
+    {
+        return [f = *this->impl]() mutable { f(); };
+    }
+
+    std::function< void() > clone_body( std::false_type )
+    {
+        return {};
+    }
 };
 
 } // namespace redGrapes
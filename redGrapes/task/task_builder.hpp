@@ -80,7 +80,7 @@ struct TaskBuilder
         // construct task in-place
         new (task) FunTask< Impl >();
 
-        task->arena_id = SingletonContext::get().current_arena;
+        task->arena_id = alloc.worker_id;
 
         // init properties from args
         PropBuildHelper<TaskBuilder> build_helper{ *this };
@@ -122,6 +122,16 @@ struct TaskBuilder
         return *this;
     }
 
+    /*! release the task without submitting it,
+     * the caller is responsible to submit it to `space`
+     */
+    Task * detach()
+    {
+        Task * t = task;
+        task = nullptr;
+        return t;
+    }
+
     auto submit()
     {
         Task * t = task;
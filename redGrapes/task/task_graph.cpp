@@ -0,0 +1,191 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+#include <redGrapes/task/task_graph.hpp>
+#include <redGrapes/task/task.hpp>
+#include <redGrapes/task/task_space.hpp>
+#include <redGrapes/resource/resource.hpp>
+#include <redGrapes/memory/allocator.hpp>
+#include <redGrapes/util/trace.hpp>
+#include <redGrapes/redGrapes.hpp>
+
+namespace redGrapes
+{
+
+TaskGraph::~TaskGraph()
+{
+    clear();
+}
+
+void TaskGraph::clear()
+{
+    for( auto & node : nodes )
+    {
+        unsigned arena_id = node.prototype->arena_id;
+        node.prototype->~Task();
+        memory::Allocator( arena_id ).deallocate( memory::Block{ (uintptr_t)node.prototype, sizeof(Task) } );
+    }
+
+    nodes.clear();
+    users.clear();
+}
+
+void TaskGraph::begin_record()
+{
+    auto & ctx = SingletonContext::get();
+    if( ctx.recording )
+        throw std::runtime_error("TaskGraph: already recording");
+
+    clear();
+
+    ctx.recording = this;
+    ctx.recording_space = ctx.current_task_space().get();
+}
+
+void TaskGraph::end_record()
+{
+    auto & ctx = SingletonContext::get();
+    if( ctx.recording == this )
+    {
+        ctx.recording = nullptr;
+        ctx.recording_space = nullptr;
+    }
+
+    users.clear();
+}
+
+/* computes the dependencies of the new task among the recorded tasks
+ * the same way as `GraphProperty::init_graph()`, but on the recorded
+ * sequence instead of the current users of each resource.
+ */
+void TaskGraph::record_task( Task & task )
+{
+    TRACE_EVENT("TaskGraph", "record_task");
+
+    Task * prototype = task.clone();
+    if( ! prototype )
+        throw std::runtime_error("TaskGraph: can not record task, its body is not copyable");
+
+    unsigned idx = nodes.size();
+    nodes.push_back( Node{ prototype, {}, {} } );
+    Node & node = nodes.back();
+
+    for( auto r = prototype->unique_resources.rbegin(); r != prototype->unique_resources.rend(); ++r )
+    {
+        auto & resource_users = users[ r->resource.get() ];
+        if( ! resource_users.empty() && resource_users.back() == idx )
+            continue;
+
+        bool reaches_outside = true;
+        for( auto it = resource_users.rbegin(); it != resource_users.rend(); ++it )
+        {
+            Task & preceding_task = *nodes[ *it ].prototype;
+            if( ResourceUser::is_serial( preceding_task, *prototype ) )
+            {
+                if( std::find( node.predecessors.begin(), node.predecessors.end(), *it ) == node.predecessors.end() )
+                    node.predecessors.push_back( *it );
+
+                if( preceding_task.has_sync_access( r->resource ) )
+                {
+                    reaches_outside = false;
+                    break;
+                }
+            }
+        }
+
+        if( reaches_outside )
+            node.boundary.push_back( r->resource );
+
+        resource_users.push_back( idx );
+    }
+}
+
+void TaskGraph::replay()
+{
+    TRACE_EVENT("TaskGraph", "replay");
+
+    size_t n = nodes.size();
+    if( n == 0 )
+        return;
+
+    auto & ctx = SingletonContext::get();
+    std::shared_ptr< TaskSpace > space = ctx.current_task_space();
+
+    /* create all tasks first, so none of them can start
+     * before all edges are added.
+     * Distribute them in contiguous blocks over the arenas like `emplace_tasks()`.
+     */
+    std::vector< Task * > tasks( n );
+    unsigned first_worker = ctx.next_worker++;
+    for( size_t i = 0; i < n; ++i )
+    {
+        ctx.current_arena = ( first_worker + i * ctx.worker_pool->size() / n ) % ctx.worker_pool->size();
+
+        Task * task = nodes[ i ].prototype->clone();
+        task->task = task;
+        task->space = space;
+        task->pre_event.up();
+        tasks[ i ] = task;
+    }
+
+    /* dependencies to tasks outside of the graph,
+     * searched before the new tasks appear as users of the resources
+     */
+    for( size_t i = 0; i < n; ++i )
+        for( auto & resource : nodes[ i ].boundary )
+        {
+            // corresponding lock to delete_from_resources()
+            std::unique_lock< SpinLock > lock( resource->users_mutex );
+
+            for( auto it = resource->users.rbegin(); it != resource->users.rend(); ++it )
+            {
+                Task * preceding_task = *it;
+
+                if( preceding_task == space->parent )
+                    break;
+
+                if(
+                   preceding_task->space == space &&
+                   space->is_serial( *preceding_task, *tasks[ i ] )
+                )
+                {
+                    tasks[ i ]->add_dependency( *preceding_task );
+                    if( preceding_task->has_sync_access( resource ) )
+                        break;
+                }
+            }
+        }
+
+    space->task_count += n;
+    for( size_t i = 0; i < n; ++i )
+        space->add_task( tasks[ i ] );
+
+    // recorded dependencies
+    for( size_t i = 0; i < n; ++i )
+        for( unsigned j : nodes[ i ].predecessors )
+            tasks[ i ]->add_dependency( *tasks[ j ] );
+
+    SPDLOG_TRACE("replay {} tasks", n);
+    for( size_t i = 0; i < n; ++i )
+    {
+        Task * task = tasks[ i ];
+
+        // activates the task if it is ready
+        task->get_pre_event().notify();
+
+        // results are not needed
+        task->get_result_get_event().notify();
+    }
+}
+
+} // namespace redGrapes
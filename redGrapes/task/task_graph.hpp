@@ -0,0 +1,115 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/task/task_graph.hpp
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace redGrapes
+{
+
+struct Task;
+struct TaskSpace;
+struct ResourceBase;
+
+/*! Recorded sequence of tasks, which can be emplaced
+ * again at once, e.g. for each iteration of a time-stepping loop.
+ *
+ * While recording, each task that is submitted to the current
+ * task space is copied (properties and body) and the dependencies
+ * among the recorded tasks are computed once.
+ * `replay()` creates new tasks from these copies and connects them
+ * with the recorded edges directly, instead of searching the
+ * users of each resource and checking `is_serial()` again.
+ * Only resources whose search reached beyond the first recorded
+ * tasks (i.e. without a synchronizing access inside the recording)
+ * are searched for preceding tasks outside of the graph.
+ *
+ *     rg::TaskGraph step;
+ *     step.record( [&]{ ... emplace tasks of one iteration ... } );
+ *     for( int i = 1; i < n_steps; ++i )
+ *         step.replay();
+ *
+ * The tasks are executed while recording as usual.
+ * Bodies have to be copyable, their results are discarded on replay.
+ * Tasks emplaced by other threads or as children of recorded tasks
+ * are not part of the graph.
+ * A TaskGraph has to be destroyed before its context is finalized.
+ */
+struct TaskGraph
+{
+    struct Node
+    {
+        //! copy of the recorded task, never submitted
+        Task * prototype;
+
+        //! indices of recorded nodes this node depends on
+        std::vector< unsigned > predecessors;
+
+        //! resources which need to be searched for preceding tasks outside of the graph
+        std::vector< std::shared_ptr< ResourceBase > > boundary;
+    };
+
+    std::vector< Node > nodes;
+
+    TaskGraph() = default;
+    TaskGraph( TaskGraph && ) = default;
+    TaskGraph( TaskGraph const & ) = delete;
+    ~TaskGraph();
+
+    //! record all tasks emplaced by `f` into this graph (see `begin_record()`)
+    template < typename F >
+    void record( F && f )
+    {
+        begin_record();
+        try
+        {
+            f();
+        }
+        catch( ... )
+        {
+            end_record();
+            throw;
+        }
+        end_record();
+    }
+
+    /*! start recording the tasks submitted to the current task space
+     * of the current context, discarding a previous recording.
+     */
+    void begin_record();
+    void end_record();
+
+    //! called by TaskSpace for each task submitted while recording
+    void record_task( Task & task );
+
+    /*! emplace a new instance of the recorded tasks
+     * into the current task space
+     */
+    void replay();
+
+    size_t size() const
+    {
+        return nodes.size();
+    }
+
+private:
+    void clear();
+
+    //! recorded nodes accessing each resource, in order, only while recording
+    std::unordered_map< ResourceBase *, std::vector< unsigned > > users;
+};
+
+} // namespace redGrapes
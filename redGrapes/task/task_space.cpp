@@ -20,9 +20,10 @@ namespace redGrapes
     {
     }
 
-    TaskSpace::TaskSpace()
+    TaskSpace::TaskSpace( Context & ctx )
         : depth(0)
         , parent(nullptr)
+        , ctx(ctx)
     {
         task_count = 0;
     }
@@ -31,6 +32,7 @@ namespace redGrapes
     TaskSpace::TaskSpace(Task * parent)
         : depth(parent->space->depth + 1)
         , parent(parent)
+        , ctx(parent->space->ctx)
     {
         task_count = 0;
     }
@@ -59,34 +61,79 @@ namespace redGrapes
         unsigned arena_id = task->arena_id;
         task->~Task();
 
+        /* return the memory to the arena it was allocated from,
+         * workers may share the allocator of their PU instead
+         */
         // FIXME: len of the Block is not correct since FunTask object is bigger than sizeof(Task)
-        SingletonContext::get().worker_pool->get_worker( arena_id ).alloc.deallocate( memory::Block{ (uintptr_t)task, sizeof(Task) } );
+        ctx.worker_pool->get_alloc( arena_id ).deallocate( memory::Block{ (uintptr_t)task, sizeof(Task) } );
 
         // TODO: implement this using post-event of root-task?
         //  - event already has in_edge count
         //  -> never have current_task = nullptr
         //spdlog::info("kill task... {} remaining", count);
         if( count == 0 )
-            SingletonContext::get().scheduler->wake_all();
+        {
+            // may be the last reference of a task from outside of `ctx`
+            ContextScope scope( ctx );
+            ctx.scheduler->wake_all();
+        }
     }
 
-    void TaskSpace::submit( Task * task )
+    void TaskSpace::add_task( Task * task )
     {
-        TRACE_EVENT("TaskSpace", "submit()");
         task->space = shared_from_this();
         task->task = task;
 
-        ++ task_count;
-
         if( parent )
+        {
             assert( this->is_superset(*parent, *task) );
 
+            /* add the dependency to the parent right away, while it is still running.
+             * init_graph() may run only after the parent finished,
+             * which would revive its already reached post-event.
+             */
+            SPDLOG_TRACE("add event dep to parent");
+            task->post_event.add_follower( parent->get_post_event() );
+        }
+
         for( auto r = task->unique_resources.rbegin(); r != task->unique_resources.rend(); ++r )
         {
             r->task_entry = r->resource->users.push( task );
         }
+    }
+
+    void TaskSpace::submit( Task * task )
+    {
+        TRACE_EVENT("TaskSpace", "submit()");
+
+        /* a TaskBuilder may submit its task after the scope of
+         * `Context::emplace_task()` ended, e.g. from a task of another context
+         */
+        ContextScope scope( ctx );
+
+        ++ task_count;
+        add_task( task );
+
+        if( ctx.recording && ctx.recording_space == this )
+            ctx.recording->record_task( *task );
+
+        ctx.scheduler->emplace_task( *task );
+    }
+
+    void TaskSpace::submit_bulk( Task ** tasks, size_t n )
+    {
+        TRACE_EVENT("TaskSpace", "submit_bulk()");
+        ContextScope scope( ctx );
+
+        task_count += n;
+        for( size_t i = 0; i < n; ++i )
+            add_task( tasks[i] );
+
+        if( ctx.recording && ctx.recording_space == this )
+            for( size_t i = 0; i < n; ++i )
+                ctx.recording->record_task( *tasks[i] );
 
-        SingletonContext::get().scheduler->emplace_task( *task );
+        ctx.scheduler->emplace_tasks( tasks, n );
     }
 
 } // namespace redGrapes
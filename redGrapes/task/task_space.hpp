@@ -19,6 +19,8 @@
 namespace redGrapes
 {
 
+struct Context;
+
 /*! TaskSpace handles sub-taskspaces of child tasks
  */
 struct TaskSpace : std::enable_shared_from_this<TaskSpace>
@@ -28,13 +30,16 @@ struct TaskSpace : std::enable_shared_from_this<TaskSpace>
     unsigned depth;
     Task * parent;
 
+    //! context whose scheduler and allocators are used for the tasks
+    Context & ctx;
+
     std::shared_mutex active_child_spaces_mutex;
     std::vector< std::shared_ptr< TaskSpace > > active_child_spaces;
 
     virtual ~TaskSpace();
     
     // top space
-    TaskSpace();
+    TaskSpace( Context & ctx );
 
     // sub space
     TaskSpace( Task * parent );
@@ -45,10 +50,20 @@ struct TaskSpace : std::enable_shared_from_this<TaskSpace>
     // add a new task to the task-space
     void submit( Task * task );
 
+    // add `n` new tasks to the task-space at once
+    void submit_bulk( Task ** tasks, size_t n );
+
     // remove task from task-space
     void free_task( Task * task );
 
     bool empty() const;
+
+private:
+    // replays tasks which are already connected
+    friend struct TaskGraph;
+
+    // link task to this space and insert it into the users of its resources
+    void add_task( Task * task );
 };
 
 } // namespace redGrapes
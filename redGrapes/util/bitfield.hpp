@@ -125,9 +125,39 @@ struct AtomicBitfield
 
 
 
+    /* searches for a bit of state `expected_value` in the
+     * index range [begin, end) which suffices the condition given by `f`.
+     * Only the chunks overlapping this range are touched.
+     *
+     * @return element given by `f(idx)` where `state[idx] == expected_value`
+     */
+    template <typename T, typename F>
+    inline std::optional< T >
+    probe_range_by_value(
+        F && f,
+        bool expected_value,
+        unsigned begin,
+        unsigned end)
+    {
+        for( uint64_t j = begin / bitfield_len; j * bitfield_len < end; ++j )
+        {
+            uint64_t mask = ~0;
+
+            if( j == begin / bitfield_len )
+                mask &= uint64_t(-1) << (begin % bitfield_len);
+
+            if( (j + 1) * bitfield_len > end )
+                mask &= (uint64_t(1) << (end % bitfield_len)) - 1;
+
+            if( auto x = probe_chunk_by_value<T>( j, mask, expected_value, f ) )
+                return x;
+        }
+
+        return std::nullopt;
+    }
+
 private:
     // TODO: try different values, e.g. 8
-    // to add hierarchy matching the NUMA architecture
     static constexpr uint64_t bitfield_len = 64;
 
     size_t m_size;
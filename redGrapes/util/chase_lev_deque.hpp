@@ -0,0 +1,184 @@
+/* Copyright 2024 The RedGrapes Community
+ *
+ * Authors: Michael Sippel
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * @file redGrapes/util/chase_lev_deque.hpp
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace redGrapes
+{
+
+/* Work-stealing deque after
+ *   D. Chase, Y. Lev: "Dynamic Circular Work-Stealing Deque" (SPAA 2005)
+ * with the memory orderings given in
+ *   N. M. Lê et al.: "Correct and Efficient Work-Stealing for
+ *   Weak Memory Models" (PPoPP 2013).
+ *
+ * Exactly one thread (the owner) may call `push()` and `pop()`,
+ * which operate LIFO at the bottom end.
+ * Any other thread may call `steal()` which takes elements FIFO
+ * from the top end, so thieves always get the oldest element.
+ *
+ * `T` must be a pointer type, nullptr is returned if the deque is empty.
+ */
+template < typename T >
+struct ChaseLevDeque
+{
+private:
+    struct Array
+    {
+        int64_t const capacity;
+        std::unique_ptr< std::atomic< T >[] > buf;
+
+        Array( int64_t capacity )
+            : capacity( capacity )
+            , buf( new std::atomic< T >[ capacity ] )
+        {}
+
+        inline T get( int64_t i ) const
+        {
+            return buf[ i & (capacity - 1) ].load( std::memory_order_relaxed );
+        }
+
+        inline void put( int64_t i, T x )
+        {
+            buf[ i & (capacity - 1) ].store( x, std::memory_order_relaxed );
+        }
+    };
+
+    alignas(64) std::atomic< int64_t > top;
+    alignas(64) std::atomic< int64_t > bottom;
+    alignas(64) std::atomic< Array * > array;
+
+    /* arrays which were replaced by `grow()` can still be read
+     * by concurrent thieves, so they are only freed together
+     * with the deque. Only the owner touches this list.
+     */
+    std::vector< std::unique_ptr< Array > > arrays;
+
+    Array * grow( Array * a, int64_t b, int64_t t )
+    {
+        arrays.emplace_back( new Array( a->capacity * 2 ) );
+        Array * new_a = arrays.back().get();
+        for( int64_t i = t; i < b; ++i )
+            new_a->put( i, a->get( i ) );
+
+        array.store( new_a, std::memory_order_release );
+        return new_a;
+    }
+
+public:
+    /*! @param capacity initial number of slots, rounded up to a power of two
+     */
+    ChaseLevDeque( size_t capacity = 64 )
+        : top( 0 )
+        , bottom( 0 )
+    {
+        int64_t c = 1;
+        while( c < int64_t(capacity) )
+            c <<= 1;
+
+        arrays.emplace_back( new Array( c ) );
+        array.store( arrays.back().get(), std::memory_order_relaxed );
+    }
+
+    ChaseLevDeque( ChaseLevDeque const & ) = delete;
+
+    /*! approximate number of elements, may be called by any thread
+     */
+    inline size_t size() const
+    {
+        int64_t b = bottom.load( std::memory_order_relaxed );
+        int64_t t = top.load( std::memory_order_relaxed );
+        return b > t ? size_t(b - t) : 0;
+    }
+
+    /*! insert element at the bottom end.
+     * may only be called by the owner.
+     */
+    inline void push( T x )
+    {
+        int64_t b = bottom.load( std::memory_order_relaxed );
+        int64_t t = top.load( std::memory_order_acquire );
+        Array * a = array.load( std::memory_order_relaxed );
+
+        if( b - t > a->capacity - 1 )
+            a = grow( a, b, t );
+
+        a->put( b, x );
+        std::atomic_thread_fence( std::memory_order_release );
+        bottom.store( b + 1, std::memory_order_relaxed );
+    }
+
+    /*! remove the most recently pushed element.
+     * may only be called by the owner.
+     *
+     * @return nullptr if empty
+     */
+    inline T pop()
+    {
+        int64_t b = bottom.load( std::memory_order_relaxed ) - 1;
+        Array * a = array.load( std::memory_order_relaxed );
+        bottom.store( b, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_seq_cst );
+        int64_t t = top.load( std::memory_order_relaxed );
+
+        T x = nullptr;
+        if( t <= b )
+        {
+            x = a->get( b );
+            if( t == b )
+            {
+                // last element, race against thieves
+                if( ! top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) )
+                    x = nullptr;
+                bottom.store( b + 1, std::memory_order_relaxed );
+            }
+        }
+        else
+            bottom.store( b + 1, std::memory_order_relaxed );
+
+        return x;
+    }
+
+    /*! remove the oldest element.
+     * may be called by any thread.
+     *
+     * @return nullptr if empty
+     */
+    inline T steal()
+    {
+        while( true )
+        {
+            int64_t t = top.load( std::memory_order_acquire );
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+            int64_t b = bottom.load( std::memory_order_acquire );
+
+            if( t >= b )
+                return nullptr;
+
+            Array * a = array.load( std::memory_order_acquire );
+            T x = a->get( t );
+
+            if( top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) )
+                return x;
+
+            // lost the race against another thief or the owner, retry
+        }
+    }
+};
+
+} // namespace redGrapes
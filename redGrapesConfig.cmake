@@ -39,8 +39,7 @@ else()
   message(STATUS "Found hwloc")
 endif()
 
-if( NOT TARGET redGrapes )
-add_library(redGrapes
+set(redGrapes_SOURCES
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/resource/resource.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/resource/resource_user.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/dispatch/thread/execute.cpp
@@ -50,15 +49,22 @@ add_library(redGrapes
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/scheduler/event.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/scheduler/event_ptr.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/scheduler/default_scheduler.cpp
+  ${CMAKE_CURRENT_LIST_DIR}/redGrapes/scheduler/blocking_scheduler.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/task/property/graph.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/task/task_space.cpp
+  ${CMAKE_CURRENT_LIST_DIR}/redGrapes/task/task_graph.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/task/queue.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/memory/allocator.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/memory/bump_allocator.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/sync/cv.cpp
+  ${CMAKE_CURRENT_LIST_DIR}/redGrapes/sync/futex_cv.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/util/trace.cpp
   ${CMAKE_CURRENT_LIST_DIR}/redGrapes/redGrapes.cpp
 )
+
+if( NOT TARGET redGrapes )
+add_library(redGrapes ${redGrapes_SOURCES})
+set(redGrapes_CREATED_TARGET ON)
 endif()
 
 target_compile_features(redGrapes PUBLIC
@@ -107,5 +113,7 @@ if(redGrapes_ENABLE_PERFETTO)
     set(redGrapes_LIBRARIES ${Boost_LIBRARIES} fmt::fmt spdlog::spdlog perfetto ${CMAKE_THREAD_LIBS_INIT})
 endif()
 
-target_include_directories(redGrapes PUBLIC ${redGrapes_INCLUDE_DIRS})
-
+# the target keeps the configuration of the project which created it
+if(redGrapes_CREATED_TARGET)
+    target_include_directories(redGrapes PUBLIC ${redGrapes_INCLUDE_DIRS})
+endif()
@@ -0,0 +1,86 @@
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <redGrapes/util/chase_lev_deque.hpp>
+
+TEST_CASE("ChaseLevDeque sequential")
+{
+    redGrapes::ChaseLevDeque< int * > d( 2 );
+    std::vector< int > v( 100 );
+
+    REQUIRE( d.pop() == nullptr );
+    REQUIRE( d.steal() == nullptr );
+
+    for( int i = 0; i < 100; ++i )
+        d.push( &v[i] );
+
+    REQUIRE( d.size() == 100 );
+
+    // owner takes LIFO
+    REQUIRE( d.pop() == &v[99] );
+    REQUIRE( d.pop() == &v[98] );
+
+    // thieves take FIFO
+    REQUIRE( d.steal() == &v[0] );
+    REQUIRE( d.steal() == &v[1] );
+
+    for( int i = 97; i >= 2; --i )
+        REQUIRE( d.pop() == &v[i] );
+
+    REQUIRE( d.pop() == nullptr );
+    REQUIRE( d.size() == 0 );
+}
+
+TEST_CASE("ChaseLevDeque concurrent steal")
+{
+    int const n_items = 100000;
+    int const n_thieves = 3;
+
+    std::vector< int > items( n_items );
+    std::vector< std::atomic< int > > taken( n_items );
+    for( auto & t : taken )
+        t = 0;
+
+    redGrapes::ChaseLevDeque< int * > d( 16 );
+    std::atomic< bool > done{ false };
+    std::atomic< int > n_taken{ 0 };
+
+    std::vector< std::thread > thieves;
+    for( int i = 0; i < n_thieves; ++i )
+        thieves.emplace_back([&] {
+            while( ! done || d.size() > 0 )
+                if( int * x = d.steal() )
+                {
+                    taken[ x - &items[0] ]++;
+                    n_taken++;
+                }
+        });
+
+    for( int i = 0; i < n_items; ++i )
+    {
+        d.push( &items[i] );
+
+        // owner pops every third element itself
+        if( i % 3 == 0 )
+            if( int * x = d.pop() )
+            {
+                taken[ x - &items[0] ]++;
+                n_taken++;
+            }
+    }
+
+    while( int * x = d.pop() )
+    {
+        taken[ x - &items[0] ]++;
+        n_taken++;
+    }
+
+    done = true;
+    for( auto & t : thieves )
+        t.join();
+
+    REQUIRE( n_taken == n_items );
+    for( int i = 0; i < n_items; ++i )
+        REQUIRE( taken[i] == 1 );
+}
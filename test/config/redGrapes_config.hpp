@@ -0,0 +1,43 @@
+#pragma once
+
+/* task properties required by the schedulers under test,
+ * the library is compiled with this configuration for the tests
+ */
+
+#include <redGrapes/task/property/priority.hpp>
+#include <redGrapes/task/property/cost.hpp>
+#include <redGrapes/task/property/gang.hpp>
+#include <redGrapes/scheduler/tag_match_property.hpp>
+
+enum SchedulerTags
+{
+    SCHED_BLOCKING
+};
+
+#define REDGRAPES_TASK_PROPERTIES \
+    redGrapes::PriorityProperty, \
+    redGrapes::CostProperty, \
+    redGrapes::GangProperty, \
+    redGrapes::scheduler::SchedulingTagProperties< SchedulerTags >
+
+template <>
+struct fmt::formatter< SchedulerTags >
+{
+    constexpr auto parse( format_parse_context& ctx )
+    {
+        return ctx.begin();
+    }
+
+    template < typename FormatContext >
+    auto format(
+        SchedulerTags const & tag,
+        FormatContext & ctx
+    )
+    {
+        switch(tag)
+        {
+        case SCHED_BLOCKING: return fmt::format_to(ctx.out(), "\"BLOCKING\"");
+        default: return fmt::format_to(ctx.out(), "\"undefined\"");
+        }
+    }
+};
@@ -33,3 +33,41 @@ TEST_CASE("CV")
     }
 
 }
+
+template < typename CV >
+void test_ping_pong( unsigned timeout )
+{
+    CV a( timeout ), b( timeout );
+    unsigned const n = 20000;
+    std::atomic< unsigned > count = {0};
+
+    std::thread t([&] {
+        for( unsigned i = 0; i < n; ++i )
+        {
+            a.wait();
+            count++;
+            b.notify();
+        }
+    });
+
+    for( unsigned i = 0; i < n; ++i )
+    {
+        a.notify();
+        b.wait();
+        REQUIRE( count == i + 1 );
+    }
+
+    t.join();
+}
+
+TEST_CASE("CV PingPong")
+{
+    test_ping_pong< redGrapes::MutexCondVar >( 0 );
+    test_ping_pong< redGrapes::MutexCondVar >( 0x1000 );
+
+#if REDGRAPES_HAS_FUTEX
+    test_ping_pong< redGrapes::FutexCondVar >( 0 );
+    test_ping_pong< redGrapes::FutexCondVar >( 0x1000 );
+    test_ping_pong< redGrapes::FutexCondVar >( REDGRAPES_CONDVAR_TIMEOUT );
+#endif
+}
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <redGrapes/redGrapes.hpp>
 #include <redGrapes/resource/ioresource.hpp>
+#include <redGrapes/scheduler/default_scheduler.hpp>
 #include <spdlog/spdlog.h>
 #include "sha256.c"
 
@@ -92,13 +93,13 @@ void generate_access_pattern()
     std::cout << "max path length = " << max_path_length << std::endl;
 }
 
-TEST_CASE("RandomGraph")
+void test_random_graph( std::shared_ptr< rg::scheduler::IScheduler > scheduler )
 {
     spdlog::set_pattern("[thread %t] %^[%l]%$ %v");
 
     generate_access_pattern();
 
-    rg::init(n_threads);
+    rg::init(n_threads, scheduler);
  
     {
        std::vector<rg::IOResource<std::array<uint64_t, 8>>> resources(n_resources);
@@ -189,3 +190,87 @@ TEST_CASE("RandomGraph")
    rg::finalize();
 }
 
+TEST_CASE("RandomGraph")
+{
+    test_random_graph( std::make_shared< rg::scheduler::DefaultScheduler >() );
+}
+
+TEST_CASE("RandomGraph ContinuationAffinity")
+{
+    auto scheduler = std::make_shared< rg::scheduler::DefaultScheduler >();
+    scheduler->continuation_affinity = true;
+    test_random_graph( scheduler );
+}
+
+TEST_CASE("RandomGraph MainThreadHelps")
+{
+    auto scheduler = std::make_shared< rg::scheduler::DefaultScheduler >();
+    scheduler->main_thread_helps = true;
+    test_random_graph( scheduler );
+}
+
+TEST_CASE("RandomGraph EagerInit")
+{
+    auto scheduler = std::make_shared< rg::scheduler::DefaultScheduler >();
+    scheduler->init_mode = rg::scheduler::DefaultScheduler::InitMode::EAGER;
+    test_random_graph( scheduler );
+}
+
+TEST_CASE("RandomGraph BuilderThreadInit")
+{
+    auto scheduler = std::make_shared< rg::scheduler::DefaultScheduler >();
+    scheduler->init_mode = rg::scheduler::DefaultScheduler::InitMode::BUILDER_THREAD;
+    test_random_graph( scheduler );
+}
+
+TEST_CASE("RandomGraph ResourceAffinity")
+{
+    rg::set_placement_policy( rg::PlacementPolicy::RESOURCE_AFFINITY );
+    test_random_graph( std::make_shared< rg::scheduler::DefaultScheduler >() );
+    rg::set_placement_policy( rg::PlacementPolicy::ROUND_ROBIN );
+}
+
+TEST_CASE("RandomGraph RandomStealHalf")
+{
+    auto scheduler = std::make_shared< rg::scheduler::DefaultScheduler >();
+    scheduler->steal_policy = rg::scheduler::DefaultScheduler::StealPolicy::RANDOM;
+    scheduler->steal_half = true;
+    test_random_graph( scheduler );
+}
+
+TEST_CASE("RandomGraph PowerOfTwoSteal")
+{
+    auto scheduler = std::make_shared< rg::scheduler::DefaultScheduler >();
+    scheduler->steal_policy = rg::scheduler::DefaultScheduler::StealPolicy::POWER_OF_TWO;
+    test_random_graph( scheduler );
+}
+
+/* compare the steal policies,
+ * run explicitly with `[benchmark]`
+ */
+TEST_CASE("RandomGraph StealPolicies", "[.][benchmark]")
+{
+    using StealPolicy = rg::scheduler::DefaultScheduler::StealPolicy;
+    std::pair< StealPolicy, char const * > policies[] = {
+        { StealPolicy::LINEAR, "linear" },
+        { StealPolicy::RANDOM, "random" },
+        { StealPolicy::POWER_OF_TWO, "power-of-two" },
+        { StealPolicy::TOPOLOGY, "topology" }
+    };
+
+    for( auto policy : policies )
+        for( bool steal_half : { false, true } )
+        {
+            auto scheduler = std::make_shared< rg::scheduler::DefaultScheduler >();
+            scheduler->steal_policy = policy.first;
+            scheduler->steal_half = steal_half;
+
+            auto begin = steady_clock::now();
+            test_random_graph( scheduler );
+            auto end = steady_clock::now();
+
+            std::cout << "steal policy " << policy.second
+                      << (steal_half ? " (steal half)" : "")
+                      << ": " << duration_cast< microseconds >( end - begin ).count() << " us" << std::endl;
+        }
+}
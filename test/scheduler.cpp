@@ -8,8 +8,21 @@
 #include <vector>
 #include <array>
 #include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <redGrapes/redGrapes.hpp>
 #include <redGrapes/resource/ioresource.hpp>
+#include <redGrapes/resource/fieldresource.hpp>
+#include <redGrapes/scheduler/default_scheduler.hpp>
+#include <redGrapes/scheduler/blocking_scheduler.hpp>
+#include <redGrapes/scheduler/tag_match.hpp>
+#include <redGrapes/scheduler/priority_scheduler.hpp>
+#include <redGrapes/scheduler/critical_path_scheduler.hpp>
+#include <redGrapes/scheduler/gang_scheduler.hpp>
+#include <redGrapes/task/parallel_for.hpp>
 #include <spdlog/spdlog.h>
 
 namespace rg = redGrapes;
@@ -55,3 +68,773 @@ TEST_CASE("WorkerUtilization")
 }
 
 
+
+TEST_CASE("BulkEmplace")
+{
+    rg::init(4);
+
+    std::vector< rg::IOResource< std::vector< unsigned > > > resources;
+    for( unsigned i = 0; i < 16; ++i )
+        resources.emplace_back();
+
+    std::vector< unsigned > indices( 10000 );
+    std::iota( indices.begin(), indices.end(), 0 );
+
+    rg::emplace_tasks(
+        indices,
+        []( unsigned i, auto r ) { r->push_back( i ); },
+        [&resources]( unsigned i ) {
+            return std::make_tuple( i, resources[ i % resources.size() ].write() );
+        });
+
+    rg::barrier();
+
+    // every task ran once, and tasks on the same resource in order
+    for( unsigned j = 0; j < resources.size(); ++j )
+    {
+        auto const & v = *resources[j];
+        REQUIRE( v.size() == indices.size() / resources.size() );
+        for( unsigned k = 0; k < v.size(); ++k )
+            REQUIRE( v[k] == j + k * resources.size() );
+    }
+
+    rg::finalize();
+}
+
+/*
+ * with RESOURCE_AFFINITY, a task is placed in the arena
+ * of its first synchronizing access
+ */
+TEST_CASE("ResourceAffinityPlacement")
+{
+    rg::init(4);
+    rg::set_placement_policy( rg::PlacementPolicy::RESOURCE_AFFINITY );
+
+    rg::IOResource< int > a, b, c;
+    unsigned arena_a = rg::ResourceAccess( a.read() ).arena_id();
+    unsigned arena_b = rg::ResourceAccess( b.write() ).arena_id();
+    unsigned arena_c = rg::ResourceAccess( c.write() ).arena_id();
+    REQUIRE( arena_a != arena_b );
+    REQUIRE( arena_b != arena_c );
+
+    std::atomic< unsigned > arena_ab{ 0 }, arena_bc{ 0 }, arena_a_only{ 0 };
+    rg::emplace_task(
+        [&]( auto, auto ) { arena_ab = rg::SingletonContext::get().current_task->arena_id; },
+        a.read(), b.write() );
+    rg::emplace_task(
+        [&]( auto, auto ) { arena_bc = rg::SingletonContext::get().current_task->arena_id; },
+        b.write(), c.write() );
+    rg::emplace_task(
+        [&]( auto ) { arena_a_only = rg::SingletonContext::get().current_task->arena_id; },
+        a.read() );
+
+    rg::barrier();
+
+    REQUIRE( arena_ab == arena_b );
+    REQUIRE( arena_bc == arena_b );
+    REQUIRE( arena_a_only == arena_a );
+
+    // the same for tasks created in bulk
+    std::vector< unsigned > arenas( 8 );
+    std::vector< unsigned > indices( arenas.size() );
+    std::iota( indices.begin(), indices.end(), 0 );
+    rg::emplace_tasks(
+        indices,
+        [&arenas]( unsigned i, auto, auto ) { arenas[i] = rg::SingletonContext::get().current_task->arena_id; },
+        [&]( unsigned i ) { return std::make_tuple( i, b.write(), c.write() ); } );
+
+    rg::barrier();
+
+    for( unsigned arena : arenas )
+        REQUIRE( arena == arena_b );
+
+    rg::set_placement_policy( rg::PlacementPolicy::ROUND_ROBIN );
+    rg::finalize();
+}
+
+/*
+ * with a single worker being blocked, the second task
+ * can only be executed by the main thread while it waits in barrier()
+ */
+TEST_CASE("MainThreadHelps")
+{
+    auto scheduler = std::make_shared< rg::scheduler::DefaultScheduler >();
+    scheduler->main_thread_helps = true;
+    rg::init(1, scheduler);
+
+    std::atomic< bool > started( false ), finished( false );
+    std::thread::id main_thread = std::this_thread::get_id();
+    std::thread::id helper_thread;
+
+    rg::emplace_task([&] {
+        started = true;
+        while( ! finished );
+    });
+
+    while( ! started );
+
+    rg::emplace_task([&] {
+        helper_thread = std::this_thread::get_id();
+        finished = true;
+    });
+
+    rg::barrier();
+
+    REQUIRE( helper_thread == main_thread );
+
+    rg::finalize();
+}
+
+/*
+ * while the only worker is blocked, tasks of mixed priorities
+ * get ready, which must then be executed from high to low priority
+ */
+TEST_CASE("PriorityScheduler")
+{
+    rg::init(1, std::make_shared< rg::scheduler::PriorityScheduler< 4 > >());
+
+    std::atomic< bool > started( false ), finished( false );
+    rg::emplace_task([&] {
+        started = true;
+        while( ! finished );
+    });
+
+    while( ! started );
+
+    std::mutex m;
+    std::vector< int > order;
+    for( int p : { 1, 0, 3, 2, 0, 3, 1 } )
+        rg::emplace_task([&m, &order, p] {
+            std::lock_guard< std::mutex > lock( m );
+            order.push_back( p );
+        }).priority( p );
+
+    finished = true;
+    rg::barrier();
+
+    REQUIRE( order.size() == 7 );
+    REQUIRE( std::is_sorted( order.begin(), order.end(), std::greater< int >() ) );
+
+    rg::finalize();
+}
+
+/*
+ * a long chain waits behind a blocking task, while many short
+ * independent tasks are ready already. Once the chain is
+ * released, it must run first since it is on the critical path
+ */
+TEST_CASE("CriticalPathScheduler")
+{
+    rg::init(1, std::make_shared< rg::scheduler::CriticalPathScheduler >());
+
+    rg::IOResource< int > chain;
+    std::atomic< bool > started( false ), finished( false );
+    rg::emplace_task([&]( auto ) {
+        started = true;
+        while( ! finished );
+    }, chain.write());
+
+    while( ! started );
+
+    std::mutex m;
+    std::vector< int > order;
+    for( int i = 0; i < 8; ++i )
+        rg::emplace_task([&m, &order] {
+            std::lock_guard< std::mutex > lock( m );
+            order.push_back( -1 );
+        }).cost( 0.5 );
+
+    for( int i = 0; i < 8; ++i )
+        rg::emplace_task([&m, &order, i]( auto ) {
+            std::lock_guard< std::mutex > lock( m );
+            order.push_back( i );
+        }, chain.write()).cost( 1.0 );
+
+    finished = true;
+    rg::barrier();
+
+    REQUIRE( order.size() == 16 );
+    for( int i = 0; i < 8; ++i )
+        REQUIRE( order[i] == i );
+
+    rg::finalize();
+}
+
+/*
+ * all k members of a gang run concurrently,
+ * and the successor of the gang task starts only after all of them finished
+ */
+TEST_CASE("GangScheduler")
+{
+    unsigned k = 3;
+    rg::init(4, std::make_shared< rg::scheduler::GangScheduler >());
+
+    rg::IOResource< int > a;
+    std::atomic< unsigned > arrived{ 0 }, finished{ 0 }, rank_mask{ 0 };
+    std::atomic< bool > concurrent{ true }, no_task{ false };
+    std::atomic< unsigned > finished_before_successor{ 0 };
+
+    for( unsigned n = 0; n < 4; ++n )
+    {
+        arrived = 0;
+        finished = 0;
+        rank_mask = 0;
+
+        rg::emplace_task(
+            [&]( auto )
+            {
+                if( rg::gang_size() != k || ! rg::SingletonContext::get().current_task )
+                    no_task = true;
+
+                rank_mask |= 1u << rg::gang_rank();
+
+                // wait until all members arrived, which requires them to run at the same time
+                arrived++;
+                auto end = steady_clock::now() + seconds( 5 );
+                while( arrived < k )
+                    if( steady_clock::now() > end )
+                    {
+                        concurrent = false;
+                        break;
+                    }
+
+                rg::gang_barrier();
+                std::this_thread::sleep_for( milliseconds( 1 ) );
+                finished++;
+            },
+            a.write() ).gang( k );
+
+        rg::emplace_task(
+            [&]( auto ) { finished_before_successor = finished.load(); },
+            a.write() );
+
+        rg::barrier();
+
+        REQUIRE( concurrent );
+        REQUIRE( ! no_task );
+        REQUIRE( finished == k );
+        REQUIRE( finished_before_successor == k );
+        REQUIRE( rank_mask == ( 1u << k ) - 1 );
+    }
+
+    rg::finalize();
+}
+
+TEST_CASE("WorkerStats")
+{
+    unsigned n_workers = std::max( 2u, std::thread::hardware_concurrency() );
+    rg::init(n_workers);
+
+    rg::IOResource< int > a;
+    for( unsigned i = 0; i < 100; ++i )
+        rg::emplace_task( []( auto a ) { (*a)++; }, a.write() );
+    for( unsigned i = 0; i < 100; ++i )
+        rg::emplace_task( []{} );
+
+    rg::barrier();
+
+    auto stats = rg::stats();
+    REQUIRE( stats.size() == n_workers );
+
+    rg::dispatch::thread::WorkerStats total;
+    for( auto const & s : stats )
+    {
+        REQUIRE( s.steal_ready_successes <= s.steal_ready_attempts );
+        REQUIRE( s.steal_new_successes <= s.steal_new_attempts );
+        total += s;
+    }
+
+    REQUIRE( total.tasks_executed == 200 );
+    REQUIRE( total.tasks_initialized == 200 );
+
+    rg::reset_stats();
+    for( auto const & s : rg::stats() )
+    {
+        REQUIRE( s.tasks_executed == 0 );
+        REQUIRE( s.tasks_initialized == 0 );
+    }
+
+    rg::finalize();
+}
+
+TEST_CASE("ElasticWorkerPool")
+{
+    rg::init(2, std::make_shared< rg::scheduler::DefaultScheduler >(), 4);
+    REQUIRE( rg::SingletonContext::get().worker_pool->size() == 2 );
+    REQUIRE( rg::SingletonContext::get().worker_pool->capacity() == 4 );
+
+    std::atomic< unsigned > count{ 0 };
+    auto run_tasks = [&count]
+    {
+        rg::IOResource< int > a;
+        for( unsigned i = 0; i < 100; ++i )
+            rg::emplace_task( [&count]( auto a ) { (*a)++; count++; }, a.write() );
+        for( unsigned i = 0; i < 100; ++i )
+            rg::emplace_task( [&count]{ count++; } );
+    };
+
+    run_tasks();
+    REQUIRE( rg::resize_workers( 4 ) == 4 );
+    run_tasks();
+    rg::barrier();
+    REQUIRE( count == 400 );
+
+    // shrink while tasks are queued
+    run_tasks();
+    REQUIRE( rg::resize_workers( 1 ) == 1 );
+    rg::barrier();
+    REQUIRE( count == 600 );
+
+    rg::reset_stats();
+    rg::set_deep_park( true );
+    run_tasks();
+    rg::barrier();
+    REQUIRE( count == 800 );
+
+    auto stats = rg::stats();
+    REQUIRE( stats.size() == 4 );
+    REQUIRE( stats[0].tasks_executed == 200 );
+    for( unsigned i = 1; i < 4; ++i )
+        REQUIRE( stats[i].tasks_executed == 0 );
+
+    // out of range is clamped
+    REQUIRE( rg::resize_workers( 0 ) == 1 );
+    REQUIRE( rg::resize_workers( 100 ) == 4 );
+    run_tasks();
+    rg::barrier();
+    REQUIRE( count == 1000 );
+
+    rg::finalize();
+}
+
+TEST_CASE("MultipleContexts")
+{
+    rg::Context ctx_a, ctx_b;
+    ctx_a.init( 2 );
+    ctx_b.init( 2 );
+
+    std::atomic< unsigned > count_a{ 0 }, count_b{ 0 };
+    std::atomic< bool > wrong_context{ false };
+
+    auto run_tasks = [&]( rg::Context & ctx, std::atomic< unsigned > & count )
+    {
+        rg::ContextScope scope( ctx );
+
+        rg::IOResource< int > a;
+        for( unsigned i = 0; i < 100; ++i )
+            rg::emplace_task(
+                [&]( auto a )
+                {
+                    if( &rg::SingletonContext::get() != &ctx )
+                        wrong_context = true;
+                    (*a)++;
+                    count++;
+                },
+                a.write() );
+
+        for( unsigned i = 0; i < 100; ++i )
+            ctx.emplace_task( [&]{ count++; } );
+    };
+
+    run_tasks( ctx_a, count_a );
+    run_tasks( ctx_b, count_b );
+
+    ctx_a.barrier();
+    ctx_b.barrier();
+
+    REQUIRE( count_a == 200 );
+    REQUIRE( count_b == 200 );
+    REQUIRE( ! wrong_context );
+
+    ctx_a.finalize();
+    ctx_b.finalize();
+}
+
+/*
+ * a task emplaced into another context from within a running task
+ * belongs to the other context and not to the running task
+ */
+TEST_CASE("MultipleContexts nested emplace")
+{
+    rg::Context ctx_a, ctx_b;
+    ctx_a.init( 2 );
+    ctx_b.init( 2 );
+
+    std::atomic< unsigned > count{ 0 };
+    std::atomic< bool > wrong_context{ false };
+
+    for( unsigned i = 0; i < 10; ++i )
+        ctx_a.emplace_task(
+            [&]
+            {
+                rg::Task * parent = rg::SingletonContext::get().current_task;
+
+                ctx_b.emplace_task(
+                    [&]
+                    {
+                        auto & ctx = rg::SingletonContext::get();
+                        if( &ctx != &ctx_b
+                            || ctx.current_task->space != ctx_b.root_space
+                            || ! ctx.current_worker
+                            || ctx.current_worker->ctx != &ctx_b )
+                            wrong_context = true;
+                        count++;
+                    });
+
+                // the state of this task is restored
+                if( &rg::SingletonContext::get() != &ctx_a
+                    || rg::SingletonContext::get().current_task != parent )
+                    wrong_context = true;
+            });
+
+    ctx_a.barrier();
+    ctx_b.barrier();
+
+    REQUIRE( count == 10 );
+    REQUIRE( ! wrong_context );
+
+    ctx_a.finalize();
+    ctx_b.finalize();
+}
+
+TEST_CASE("RestrictCpuset")
+{
+    rg::Context ctx;
+
+    hwloc_obj_t pu = hwloc_get_obj_by_type( ctx.hwloc_ctx.topology, HWLOC_OBJ_PU, 0 );
+    REQUIRE( pu );
+    hwloc_bitmap_t cpuset = hwloc_bitmap_dup( pu->cpuset );
+
+    ctx.restrict_cpuset( cpuset );
+    REQUIRE( hwloc_get_nbobjs_by_type( ctx.hwloc_ctx.topology, HWLOC_OBJ_PU ) == 1 );
+    REQUIRE( hwloc_bitmap_isequal( hwloc_get_root_obj( ctx.hwloc_ctx.topology )->cpuset, cpuset ) );
+    hwloc_bitmap_free( cpuset );
+
+    ctx.init( 2 );
+
+    std::atomic< unsigned > count{ 0 };
+    for( unsigned i = 0; i < 100; ++i )
+        ctx.emplace_task( [&]{ count++; } );
+
+    ctx.barrier();
+    REQUIRE( count == 100 );
+
+    ctx.finalize();
+}
+
+/*
+ * blocking tasks are sent to the BlockingScheduler by their tag,
+ * and their sleeps must overlap on the blocking threads,
+ * while the compute tasks stay on the compute worker
+ */
+TEST_CASE("BlockingScheduler")
+{
+    unsigned n_blocking = 8;
+    rg::init( 1,
+              rg::scheduler::make_tag_match_scheduler()
+                  .add( {}, std::make_shared< rg::scheduler::DefaultScheduler >() )
+                  .add( { SCHED_BLOCKING }, std::make_shared< rg::scheduler::BlockingScheduler >( n_blocking ) ) );
+
+    std::atomic< unsigned > count{ 0 };
+    std::atomic< unsigned > running{ 0 }, max_running{ 0 };
+    std::atomic< bool > on_compute_worker{ false }, on_blocking_thread{ false };
+
+    auto is_compute_worker = []
+    {
+        auto & worker = rg::SingletonContext::get().current_worker;
+        return worker && worker->get_worker_id() < rg::SingletonContext::get().worker_pool->capacity();
+    };
+
+    auto begin = steady_clock::now();
+
+    rg::IOResource< int > a;
+    for( unsigned i = 0; i < 2 * n_blocking; ++i )
+        rg::emplace_task(
+            [&]
+            {
+                if( is_compute_worker() )
+                    on_compute_worker = true;
+
+                unsigned r = ++running;
+                unsigned m = max_running;
+                while( r > m && ! max_running.compare_exchange_weak( m, r ) );
+
+                std::this_thread::sleep_for( milliseconds( 5 ) );
+
+                running--;
+                count++;
+            }).scheduling_tags( { SCHED_BLOCKING } );
+
+    for( unsigned i = 0; i < 10; ++i )
+        rg::emplace_task(
+            [&]( auto a )
+            {
+                if( ! is_compute_worker() )
+                    on_blocking_thread = true;
+                (*a)++;
+                count++;
+            },
+            a.write() );
+
+    rg::barrier();
+    auto elapsed = steady_clock::now() - begin;
+
+    REQUIRE( count == 2 * n_blocking + 10 );
+    REQUIRE( ! on_compute_worker );
+    REQUIRE( ! on_blocking_thread );
+
+    // 16 x 5ms would take 80ms one after another
+    REQUIRE( max_running >= n_blocking / 2 );
+    REQUIRE( elapsed < milliseconds( 60 ) );
+
+    rg::finalize();
+}
+
+TEST_CASE("ParallelFor")
+{
+    rg::init(4);
+
+    size_t n = 1000;
+    rg::FieldResource< std::vector< int > > field( n );
+
+    rg::parallel_for( field.write(), { { 0 }, { n } },
+        []( auto f, std::array< size_t, 1 > idx )
+        {
+            f[ idx ] = idx[0];
+        });
+
+    // only the second half, with coarse chunks
+    rg::parallel_for( field.write(), { { n / 2 }, { n } },
+        []( auto f, std::array< size_t, 1 > idx )
+        {
+            f[ idx ] *= 2;
+        },
+        100 );
+
+    rg::FieldResource< std::array< std::array< int, 16 >, 8 > > field2;
+    rg::parallel_for( field2.write(), { { 0, 0 }, { 16, 8 } },
+        []( auto f, std::array< size_t, 2 > idx )
+        {
+            f[ idx ] = idx[0] + 16 * idx[1];
+        });
+
+    auto check = rg::emplace_task(
+        [n]( auto f, auto f2 )
+        {
+            bool ok = true;
+            for( size_t i = 0; i < n; ++i )
+                ok = ok && f[ { i } ] == int( i < n / 2 ? i : 2 * i );
+            for( size_t y = 0; y < 8; ++y )
+                for( size_t x = 0; x < 16; ++x )
+                    ok = ok && f2[ { x, y } ] == int( x + 16 * y );
+            return ok;
+        },
+        field.read(),
+        field2.read());
+
+    REQUIRE( check.get() );
+
+    rg::finalize();
+}
+
+TEST_CASE("ParallelForLazy")
+{
+    size_t n = 512;
+
+    for( unsigned n_workers : { 1, 4 } )
+    {
+        rg::init( n_workers );
+
+        rg::FieldResource< std::vector< int > > field( n );
+
+        std::mutex m;
+        std::set< rg::Task * > tasks;
+
+        rg::parallel_for_lazy( field.write(), { { 0 }, { n } },
+            [&]( auto f, std::array< size_t, 1 > idx )
+            {
+                {
+                    std::lock_guard< std::mutex > lock( m );
+                    tasks.insert( rg::Context::current_task );
+                }
+                std::this_thread::sleep_for( std::chrono::microseconds( 20 ) );
+                f[ idx ] = idx[0];
+            },
+            8 );
+
+        auto check = rg::emplace_task(
+            [n]( auto f )
+            {
+                for( size_t i = 0; i < n; ++i )
+                    if( f[ { i } ] != int( i ) )
+                        return false;
+                return true;
+            },
+            field.read());
+
+        REQUIRE( check.get() );
+
+        // without idle workers, the range is never split
+        if( n_workers == 1 )
+            REQUIRE( tasks.size() == 1 );
+        else
+            REQUIRE( tasks.size() > 1 );
+
+        rg::finalize();
+    }
+}
+
+TEST_CASE("TaskGraph")
+{
+    rg::init(4);
+
+    rg::IOResource< long > a( 1 );
+    rg::IOResource< long > b( 0 );
+    rg::IOResource< long > c( 0 );
+
+    long exp_a = 1, exp_b = 0, exp_c = 0;
+
+    // the graph has to be destroyed before finalize()
+    {
+        rg::TaskGraph step;
+        step.record(
+            [&]
+            {
+                rg::emplace_task( []( auto a ) { *a += 1; }, a.write() );
+                rg::emplace_task( []( auto a, auto b ) { *b = *b * 2 + *a; }, a.read(), b.write() );
+                rg::emplace_task( []( auto a, auto c ) { *c += *a; }, a.read(), c.write() );
+                rg::emplace_task( []( auto a ) { *a %= 1000; }, a.write() );
+            });
+
+        REQUIRE( step.size() == 4 );
+        REQUIRE( step.nodes[0].predecessors.empty() );
+        REQUIRE( step.nodes[1].predecessors == std::vector< unsigned >{ 0 } );
+        REQUIRE( step.nodes[2].predecessors == std::vector< unsigned >{ 0 } );
+        REQUIRE( step.nodes[3].predecessors.size() == 3 );
+        REQUIRE( step.nodes[3].boundary.empty() );
+
+        auto simulate_step = [&]
+        {
+            exp_a += 1;
+            exp_b = exp_b * 2 + exp_a;
+            exp_c += exp_a;
+            exp_a %= 1000;
+        };
+        simulate_step();
+
+        for( int i = 0; i < 50; ++i )
+        {
+            step.replay();
+            simulate_step();
+
+            // tasks outside of the graph stay ordered
+            rg::emplace_task( []( auto a, auto b ) { *a += 7; *b %= 1000003; }, a.write(), b.write() );
+            exp_a += 7;
+            exp_b %= 1000003;
+        }
+    }
+
+    REQUIRE( rg::emplace_task( []( auto a ) { return *a; }, a.read() ).get() == exp_a );
+    REQUIRE( rg::emplace_task( []( auto b ) { return *b; }, b.read() ).get() == exp_b );
+    REQUIRE( rg::emplace_task( []( auto c ) { return *c; }, c.read() ).get() == exp_c );
+
+    rg::finalize();
+}
+
+TEST_CASE("ExternalEvent")
+{
+    rg::init(2);
+
+    REQUIRE( sizeof(rg::scheduler::EventPtr) == sizeof(void*) );
+
+    rg::IOResource< int > r( 0 );
+
+    auto event_f = rg::emplace_task( []( auto r ) { *r = 1; return rg::create_event(); }, r.write() );
+    auto follow_f = rg::emplace_task( []( auto r ) { return *r; }, r.read() );
+
+    std::optional< rg::scheduler::EventPtr > event = event_f.get();
+    REQUIRE( event );
+    REQUIRE( event->get_tag() == rg::scheduler::T_EVT_EXT );
+    REQUIRE( event->get_task() == nullptr );
+
+    // copies refer to the same event
+    rg::scheduler::EventPtr copy = *event;
+    REQUIRE( copy == *event );
+    event.reset();
+
+    // the first task is not finished until the event is reached
+    std::this_thread::sleep_for( milliseconds(10) );
+    REQUIRE( ! copy->is_reached() );
+
+    copy.notify();
+    REQUIRE( follow_f.get() == 1 );
+
+    // dropped events are recycled by the pool of their arena
+    rg::scheduler::ExternalEvent * first = rg::scheduler::ExternalEvent::create().get_external_event();
+    rg::scheduler::EventPtr recycled = rg::scheduler::ExternalEvent::create();
+    REQUIRE( recycled.get_external_event() == first );
+    REQUIRE( recycled->state == 1 );
+    REQUIRE( ! recycled->is_reached() );
+
+    rg::finalize();
+}
+
+TEST_CASE("EventFollowers")
+{
+    rg::init(1);
+
+    // only compared, never dereferenced
+    std::vector< rg::scheduler::EventPtr > followers;
+    for( uintptr_t i = 1; i <= 10; ++i )
+        followers.emplace_back( rg::scheduler::T_EVT_PRE, (rg::Task *)( i * 64 ) );
+
+    {
+        rg::scheduler::Event event;
+        for( auto & f : followers )
+            event.followers.push( f );
+
+        // one inline and one spilled follower
+        event.followers.erase( followers[1] );
+        event.followers.erase( followers[7] );
+
+        std::vector< rg::scheduler::EventPtr > visited;
+        event.followers.for_each( [&]( rg::scheduler::EventPtr & f ) { visited.push_back( f ); } );
+
+        std::vector< rg::scheduler::EventPtr > expected;
+        for( unsigned i = 10; i-- > 0; )
+            if( i != 1 && i != 7 )
+                expected.push_back( followers[i] );
+
+        REQUIRE( visited == expected );
+    }
+
+    rg::finalize();
+}
+
+TEST_CASE("EventChain")
+{
+    rg::init(1);
+
+    // long enough to overflow the stack with recursive notification
+    size_t const n = 100000;
+
+    std::vector< rg::scheduler::EventPtr > events;
+    events.reserve( n );
+    for( size_t i = 0; i < n; ++i )
+        events.push_back( rg::scheduler::ExternalEvent::create() );
+
+    for( size_t i = 1; i < n; ++i )
+    {
+        events[i - 1]->add_follower( events[i] );
+
+        // each event is only reached through its predecessor
+        events[i]->dn();
+    }
+
+    events[0].notify();
+
+    REQUIRE( std::all_of( events.begin(), events.end(), []( auto & e ) { return e->is_reached(); } ) );
+
+    events.clear();
+    rg::finalize();
+}